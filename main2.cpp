@@ -1,74 +1,661 @@
 #include "main2.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MAIN2_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(MAIN2_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MAIN2_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MAIN2_TARGET(isa)
+#endif
+
 char toLower(char c) {
     return tolower(c);
 }
 
+namespace {
+
+uint32_t letterMask32Scalar(const char* p) {
+    uint32_t mask = 0;
+    for (int i = 0; i < 32; i++) {
+        mask |= static_cast<uint32_t>(isAsciiLetter(p[i])) << i;
+    }
+    return mask;
+}
+
+void lowerAsciiScalar(char* dst, const char* src, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        char c = src[i];
+        dst[i] = isAsciiLetter(c) ? (c | 0x20) : c;
+    }
+}
+
+// sum of factors[e] * rank[sources[e]] in four interleaved lanes, combined
+// as (l0 + l1) + (l2 + l3) and then the tail, so every ISA rounds alike
+double pullSumScalar(const double* factors, const int* sources, const double* rank, int count) {
+    double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+    int e = 0;
+    for (; e + 4 <= count; e += 4) {
+        for (int l = 0; l < 4; l++) {
+            lanes[l] += factors[e + l] * rank[sources[e + l]];
+        }
+    }
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; e < count; e++) {
+        sum += factors[e] * rank[sources[e]];
+    }
+    return sum;
+}
+
+// out[j] = min(out[j], to_k + via[j]) over 16-bit distances: finite sums
+// clamp to SATURATED and an unreachable via[j] stays unreachable
+void minPlusRowScalar(uint16_t* out, const uint16_t* via, uint16_t to_k, int n) {
+    for (int j = 0; j < n; j++) {
+        uint32_t sum = std::min<uint32_t>(static_cast<uint32_t>(to_k) + via[j], DistanceMatrix::SATURATED);
+        uint16_t candidate = via[j] == DistanceMatrix::UNREACHABLE ? DistanceMatrix::UNREACHABLE : sum;
+        out[j] = std::min(out[j], candidate);
+    }
+}
+
+#ifdef MAIN2_X86
+// A byte is a letter when (c | 0x20) is in 'a'..'z'. Adding 0x80 - 'a'
+// maps exactly that range to -128..-103, so one signed compare suffices.
+MAIN2_TARGET("sse2") inline __m128i letterBytesSse2(__m128i v) {
+    __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i shifted = _mm_add_epi8(folded, _mm_set1_epi8(static_cast<char>(0x80 - 'a')));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26));
+}
+
+MAIN2_TARGET("sse2") uint32_t letterMask32Sse2(const char* p) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+    uint32_t lo_mask = static_cast<uint32_t>(_mm_movemask_epi8(letterBytesSse2(lo)));
+    uint32_t hi_mask = static_cast<uint32_t>(_mm_movemask_epi8(letterBytesSse2(hi)));
+    return lo_mask | (hi_mask << 16);
+}
+
+MAIN2_TARGET("sse2") void lowerAsciiSse2(char* dst, const char* src, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i bit = _mm_and_si128(letterBytesSse2(v), _mm_set1_epi8(0x20));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(v, bit));
+    }
+    lowerAsciiScalar(dst + i, src + i, n - i);
+}
+
+// SSE2 has no unsigned 16-bit min; a - subs(a, b) computes it
+MAIN2_TARGET("sse2") void minPlusRowSse2(uint16_t* out, const uint16_t* via, uint16_t to_k, int n) {
+    __m128i add = _mm_set1_epi16(static_cast<short>(to_k));
+    __m128i saturated = _mm_set1_epi16(static_cast<short>(DistanceMatrix::SATURATED));
+    __m128i unreachable = _mm_set1_epi16(-1);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(via + j));
+        __m128i o = _mm_loadu_si128(reinterpret_cast<const __m128i*>(out + j));
+        __m128i sum = _mm_adds_epu16(v, add);
+        sum = _mm_sub_epi16(sum, _mm_subs_epu16(sum, saturated));
+        sum = _mm_or_si128(sum, _mm_cmpeq_epi16(v, unreachable));
+        o = _mm_sub_epi16(o, _mm_subs_epu16(o, sum));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j), o);
+    }
+    minPlusRowScalar(out + j, via + j, to_k, n - j);
+}
+
+MAIN2_TARGET("avx2") inline __m256i letterBytesAvx2(__m256i v) {
+    __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i shifted = _mm256_add_epi8(folded, _mm256_set1_epi8(static_cast<char>(0x80 - 'a')));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+}
+
+MAIN2_TARGET("avx2") uint32_t letterMask32Avx2(const char* p) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(letterBytesAvx2(v)));
+}
+
+MAIN2_TARGET("avx2") void lowerAsciiAvx2(char* dst, const char* src, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i bit = _mm256_and_si256(letterBytesAvx2(v), _mm256_set1_epi8(0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(v, bit));
+    }
+    _mm256_zeroupper();
+    lowerAsciiSse2(dst + i, src + i, n - i);
+}
+
+MAIN2_TARGET("avx2") void minPlusRowAvx2(uint16_t* out, const uint16_t* via, uint16_t to_k, int n) {
+    __m256i add = _mm256_set1_epi16(static_cast<short>(to_k));
+    __m256i saturated = _mm256_set1_epi16(static_cast<short>(DistanceMatrix::SATURATED));
+    __m256i unreachable = _mm256_set1_epi16(-1);
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(via + j));
+        __m256i o = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + j));
+        __m256i sum = _mm256_min_epu16(_mm256_adds_epu16(v, add), saturated);
+        sum = _mm256_or_si256(sum, _mm256_cmpeq_epi16(v, unreachable));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j), _mm256_min_epu16(o, sum));
+    }
+    // Clear the upper lanes before running legacy SSE code on the tail
+    _mm256_zeroupper();
+    minPlusRowSse2(out + j, via + j, to_k, n - j);
+}
+
+MAIN2_TARGET("avx2") double pullSumAvx2(const double* factors, const int* sources, const double* rank, int count) {
+    __m256d acc = _mm256_setzero_pd();
+    // Masked gather with a zero source; the plain form reads an undefined one
+    const __m256d all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    int e = 0;
+    for (; e + 4 <= count; e += 4) {
+        __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sources + e));
+        __m256d gathered = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), rank, index, all_lanes, 8);
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(factors + e), gathered));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    _mm256_zeroupper();
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; e < count; e++) {
+        sum += factors[e] * rank[sources[e]];
+    }
+    return sum;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+bool cpuHasSse2() { return __builtin_cpu_supports("sse2"); }
+bool cpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+#else
+bool cpuHasSse2() {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+}
+
+bool cpuHasAvx2() {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool os_saves_ymm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    if (!os_saves_ymm) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+#endif
+#endif
+
+typedef uint32_t (*LetterMaskFn)(const char*);
+typedef void (*LowerAsciiFn)(char*, const char*, size_t);
+typedef void (*MinPlusRowFn)(uint16_t*, const uint16_t*, uint16_t, int);
+typedef double (*PullSumFn)(const double*, const int*, const double*, int);
+
+LetterMaskFn selectLetterMask() {
+#ifdef MAIN2_X86
+    if (cpuHasAvx2()) return letterMask32Avx2;
+    if (cpuHasSse2()) return letterMask32Sse2;
+#endif
+    return letterMask32Scalar;
+}
+
+LowerAsciiFn selectLowerAscii() {
+#ifdef MAIN2_X86
+    if (cpuHasAvx2()) return lowerAsciiAvx2;
+    if (cpuHasSse2()) return lowerAsciiSse2;
+#endif
+    return lowerAsciiScalar;
+}
+
+MinPlusRowFn selectMinPlusRow() {
+#ifdef MAIN2_X86
+    if (cpuHasAvx2()) return minPlusRowAvx2;
+    if (cpuHasSse2()) return minPlusRowSse2;
+#endif
+    return minPlusRowScalar;
+}
+
+void minPlusRow(uint16_t* out, const uint16_t* via, uint16_t to_k, int n) {
+    static const MinPlusRowFn impl = selectMinPlusRow();
+    impl(out, via, to_k, n);
+}
+
+PullSumFn selectPullSum() {
+#ifdef MAIN2_X86
+    if (cpuHasAvx2()) return pullSumAvx2;
+#endif
+    return pullSumScalar;
+}
+
+double pullSum(const double* factors, const int* sources, const double* rank, int count) {
+    static const PullSumFn impl = selectPullSum();
+    return impl(factors, sources, rank, count);
+}
+
+}  // namespace
+
+uint32_t letterMask32(const char* p) {
+    static const LetterMaskFn impl = selectLetterMask();
+    return impl(p);
+}
+
+void lowerAscii(char* dst, const char* src, size_t n) {
+    static const LowerAsciiFn impl = selectLowerAscii();
+    impl(dst, src, n);
+}
+
 WordNode::WordNode(const std::string& w) : word(w), next(nullptr) {}
 
-Graph::Graph(int vertices) : numVertices(vertices), 
-                         adjacencyMatrix(vertices, std::vector<int>(vertices, 0)) {
-    if (vertices > MAX_VERTICES) {
-        std::cerr << "Number of vertices exceeds maximum limit" << std::endl;
-        exit(EXIT_FAILURE);
+Graph::Graph(int vertices) : numVertices(vertices), rowOffsets(vertices + 1, 0), inOffsets(vertices + 1, 0) {}
+
+void Graph::addEdge(int from, int to, int weight) {
+    if (from < 0 || from >= numVertices || to < 0 || to >= numVertices || weight <= 0) {
+        return;
     }
+    pendingEdges.push_back({from, to, weight});
 }
 
-int WordTable::addWord(const std::string& word) {
-    auto it = wordToIndex.find(word);
-    if (it != wordToIndex.end()) {
-        return it->second;
+void Graph::finalize() {
+    if (pendingEdges.empty()) return;
+
+    // Bucket existing and pending edges by source row
+    std::vector<int> start(numVertices + 1, 0);
+    for (int u = 0; u < numVertices; u++) {
+        start[u + 1] = rowOffsets[u + 1] - rowOffsets[u];
     }
-    
-    if (words.size() >= MAX_VERTICES) {
-        std::cerr << "Warning: Word table full, cannot add more words" << std::endl;
-        return -1;
+    for (const PendingEdge& e : pendingEdges) {
+        start[e.from + 1]++;
+    }
+    for (int u = 0; u < numVertices; u++) {
+        start[u + 1] += start[u];
+    }
+
+    std::vector<std::pair<int, int>> slots(start[numVertices]);
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for (int u = 0; u < numVertices; u++) {
+        for (int e = rowOffsets[u]; e < rowOffsets[u + 1]; e++) {
+            slots[fill[u]++] = std::make_pair(columnIndices[e], edgeWeights[e]);
+        }
+    }
+    for (const PendingEdge& e : pendingEdges) {
+        slots[fill[e.from]++] = std::make_pair(e.to, e.weight);
+    }
+    std::vector<PendingEdge>().swap(pendingEdges);
+
+    // Sort each row by target and merge duplicates
+    columnIndices.clear();
+    edgeWeights.clear();
+    columnIndices.reserve(slots.size());
+    edgeWeights.reserve(slots.size());
+    rowOffsets[0] = 0;
+    for (int u = 0; u < numVertices; u++) {
+        std::sort(slots.begin() + start[u], slots.begin() + start[u + 1]);
+        for (int i = start[u]; i < start[u + 1]; i++) {
+            if (i > start[u] && slots[i].first == columnIndices.back()) {
+                edgeWeights.back() += slots[i].second;
+            } else {
+                columnIndices.push_back(slots[i].first);
+                edgeWeights.push_back(slots[i].second);
+            }
+        }
+        rowOffsets[u + 1] = columnIndices.size();
+    }
+
+    // Reverse CSR; scanning sources in order keeps each in-row sorted
+    inOffsets.assign(numVertices + 1, 0);
+    for (int v : columnIndices) {
+        inOffsets[v + 1]++;
+    }
+    for (int v = 0; v < numVertices; v++) {
+        inOffsets[v + 1] += inOffsets[v];
+    }
+    inSources.resize(columnIndices.size());
+    inWeights.resize(columnIndices.size());
+    std::vector<int> in_fill(inOffsets.begin(), inOffsets.end() - 1);
+    for (int u = 0; u < numVertices; u++) {
+        for (int e = rowOffsets[u]; e < rowOffsets[u + 1]; e++) {
+            int slot = in_fill[columnIndices[e]]++;
+            inSources[slot] = u;
+            inWeights[slot] = edgeWeights[e];
+        }
     }
-    
-    words.push_back(word);
-    wordToIndex[word] = words.size() - 1;
-    return words.size() - 1;
 }
 
-int WordTable::getIndex(const std::string& word) const {
-    auto it = wordToIndex.find(word);
-    return it != wordToIndex.end() ? it->second : -1;
+int Graph::numEdges() const { return columnIndices.size(); }
+
+int Graph::outDegree(int vertex) const {
+    return rowOffsets[vertex + 1] - rowOffsets[vertex];
 }
 
-size_t WordTable::size() const { return words.size(); }
+int Graph::edgeIndex(int from, int to) const {
+    auto first = columnIndices.begin() + rowOffsets[from];
+    auto last = columnIndices.begin() + rowOffsets[from + 1];
+    auto it = std::lower_bound(first, last, to);
+    return (it != last && *it == to) ? it - columnIndices.begin() : -1;
+}
 
-std::string processTextFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        perror("Error opening file");
-        return "";
+int Graph::edgeWeight(int from, int to) const {
+    int e = edgeIndex(from, to);
+    return e != -1 ? edgeWeights[e] : 0;
+}
+
+WordTable::WordTable() : blockUsed(BLOCK_SIZE), slots(16, Slot{0, 0}), frozen(false) {}
+
+// FNV-1a over the word bytes
+uint64_t WordTable::hash(std::string_view word) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : word) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
     }
+    return hash;
+}
 
-    file.seekg(0, std::ios::end);
-    size_t file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
+uint32_t WordTable::intern(std::string_view word) {
+    // Oversized words get a block of their own
+    if (blocks.empty() || word.size() > BLOCK_SIZE - blockUsed) {
+        blocks.emplace_back(new char[std::max<size_t>(BLOCK_SIZE, word.size())]);
+        blockUsed = 0;
+    }
+    uint32_t offset = static_cast<uint32_t>(blocks.size() - 1) << BLOCK_BITS | blockUsed;
+    std::copy(word.begin(), word.end(), blocks.back().get() + blockUsed);
+    blockUsed = word.size() > BLOCK_SIZE ? BLOCK_SIZE : blockUsed + word.size();
+    return offset;
+}
 
-    std::string result;
-    result.reserve(file_size * 2);
-    bool in_word = false;
-
-    char c;
-    while (file.get(c)) {
-        if (isalpha(c)) {
-            result += toLower(c);
-            in_word = true;
-        } else {
-            if (in_word) {
-                result += ' ';
-                in_word = false;
+size_t WordTable::findSlot(std::string_view word, uint32_t tag) const {
+    size_t mask = slots.size() - 1;
+    for (size_t i = tag & mask; ; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.id == 0 || (slot.tag == tag && this->word(slot.id - 1) == word)) {
+            return i;
+        }
+    }
+}
+
+void WordTable::growIndex() {
+    std::vector<Slot> old_slots(slots.size() * 2, Slot{0, 0});
+    old_slots.swap(slots);
+    size_t mask = slots.size() - 1;
+    for (const Slot& slot : old_slots) {
+        if (slot.id == 0) continue;
+        size_t i = slot.tag & mask;
+        while (slots[i].id != 0) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = slot;
+    }
+}
+
+int WordTable::addWord(std::string_view word) {
+    return addWord(word, hash(word));
+}
+
+int WordTable::addWord(std::string_view word, uint64_t hash) {
+    if (frozen) {
+        thaw();
+    }
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    size_t slot = findSlot(word, tag);
+    if (slots[slot].id != 0) {
+        return slots[slot].id - 1;
+    }
+
+    int id = offsets.size();
+    offsets.push_back(intern(word));
+    lengths.push_back(word.size());
+    slots[slot] = Slot{static_cast<uint32_t>(id + 1), tag};
+
+    // Keep the load factor at or below one half
+    if (offsets.size() * 2 > slots.size()) {
+        growIndex();
+    }
+    return id;
+}
+
+int WordTable::getIndex(std::string_view word) const {
+    return getIndex(word, hash(word));
+}
+
+int WordTable::getIndex(std::string_view word, uint64_t hash) const {
+    if (frozen) {
+        if (perfectIds.empty()) return -1;
+        uint32_t pilot = pilots[perfectBucket(hash)];
+        size_t slot = (pilot & DIRECT_PILOT) ? (pilot & ~DIRECT_PILOT) : perfectSlot(hash, pilot);
+        int id = perfectIds[slot];
+        return this->word(id) == word ? id : -1;
+    }
+    size_t slot = findSlot(word, static_cast<uint32_t>(hash >> 32));
+    return static_cast<int>(slots[slot].id) - 1;
+}
+
+namespace {
+
+uint64_t mixHash(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+}  // namespace
+
+size_t WordTable::perfectBucket(uint64_t hash) const {
+    return static_cast<uint32_t>(hash) % pilots.size();
+}
+
+size_t WordTable::perfectSlot(uint64_t hash, uint32_t pilot) const {
+    return mixHash(hash ^ (pilot * 0x9e3779b97f4a7c15ull)) % perfectIds.size();
+}
+
+bool WordTable::freeze() {
+    if (frozen) return true;
+    size_t n = size();
+    std::vector<uint64_t> hashes(n);
+    for (size_t id = 0; id < n; id++) {
+        hashes[id] = hash(word(id));
+    }
+
+    // About four keys per bucket; place the largest buckets first
+    pilots.assign(n / 4 + 1, 0);
+    perfectIds.assign(n, 0);
+    std::vector<std::vector<uint32_t>> buckets(pilots.size());
+    for (size_t id = 0; id < n; id++) {
+        buckets[perfectBucket(hashes[id])].push_back(id);
+    }
+    std::vector<uint32_t> order(buckets.size());
+    for (size_t b = 0; b < order.size(); b++) order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<bool> taken(n, false);
+    std::vector<size_t> positions;
+    size_t next_free = 0;
+    for (uint32_t b : order) {
+        const std::vector<uint32_t>& keys = buckets[b];
+        if (keys.empty()) break;
+        if (keys.size() == 1) {
+            while (taken[next_free]) next_free++;
+            pilots[b] = DIRECT_PILOT | next_free;
+            perfectIds[next_free] = keys[0];
+            taken[next_free] = true;
+            continue;
+        }
+
+        bool placed = false;
+        for (uint32_t pilot = 0; pilot < (1u << 24) && !placed; pilot++) {
+            positions.clear();
+            for (uint32_t id : keys) {
+                size_t slot = perfectSlot(hashes[id], pilot);
+                if (taken[slot] || std::find(positions.begin(), positions.end(), slot) != positions.end()) {
+                    break;
+                }
+                positions.push_back(slot);
+            }
+            if (positions.size() == keys.size()) {
+                pilots[b] = pilot;
+                for (size_t k = 0; k < keys.size(); k++) {
+                    perfectIds[positions[k]] = keys[k];
+                    taken[positions[k]] = true;
+                }
+                placed = true;
             }
         }
+        if (!placed) {
+            // Colliding 64-bit hashes: keep the regular index
+            std::vector<uint32_t>().swap(pilots);
+            std::vector<uint32_t>().swap(perfectIds);
+            return false;
+        }
     }
 
-    if (in_word) {
-        result += ' ';
+    std::vector<Slot>().swap(slots);
+    frozen = true;
+    return true;
+}
+
+bool WordTable::isFrozen() const { return frozen; }
+
+void WordTable::thaw() {
+    size_t capacity = 16;
+    while (capacity < size() * 2 + 2) capacity *= 2;
+    slots.assign(capacity, Slot{0, 0});
+    size_t mask = capacity - 1;
+    for (size_t id = 0; id < size(); id++) {
+        uint32_t tag = static_cast<uint32_t>(hash(word(id)) >> 32);
+        size_t i = tag & mask;
+        while (slots[i].id != 0) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = Slot{static_cast<uint32_t>(id + 1), tag};
+    }
+    std::vector<uint32_t>().swap(pilots);
+    std::vector<uint32_t>().swap(perfectIds);
+    frozen = false;
+}
+
+std::string_view WordTable::word(int id) const {
+    uint32_t offset = offsets[id];
+    return std::string_view(blocks[offset >> BLOCK_BITS].get() + (offset & (BLOCK_SIZE - 1)), lengths[id]);
+}
+
+size_t WordTable::size() const { return offsets.size(); }
+
+MappedFile::MappedFile(const std::string& filename)
+    : opened(false), mappedData(nullptr), mappedSize(0),
+      fileHandle(nullptr), mappingHandle(nullptr) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return;
+    }
+    fileHandle = file;
+    opened = true;
+    mappedSize = static_cast<size_t>(file_size.QuadPart);
+    if (mappedSize == 0) {
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+        mappedData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (mappedData) {
+            mappingHandle = mapping;
+            return;
+        }
+        CloseHandle(mapping);
+    }
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return;
+    }
+    opened = true;
+    mappedSize = static_cast<size_t>(st.st_size);
+    if (mappedSize == 0) {
+        close(fd);
+        return;
+    }
+    void* addr = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr != MAP_FAILED) {
+        madvise(addr, mappedSize, MADV_SEQUENTIAL);
+        mappedData = static_cast<const char*>(addr);
+        return;
+    }
+#endif
+
+    // Mapping failed: fall back to reading the whole file
+    std::ifstream file(filename, std::ios::binary);
+    buffer.resize(mappedSize);
+    if (!file.read(buffer.data(), buffer.size())) {
+        buffer.resize(file.gcount());
+    }
+    mappedSize = buffer.size();
+}
+
+MappedFile::~MappedFile() {
+    if (!buffer.empty() || !mappedData) {
+#ifdef _WIN32
+        if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+#endif
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+#else
+    munmap(const_cast<char*>(mappedData), mappedSize);
+#endif
+}
+
+bool MappedFile::isOpen() const { return opened; }
+
+const char* MappedFile::data() const {
+    return buffer.empty() ? mappedData : buffer.data();
+}
+
+size_t MappedFile::size() const { return mappedSize; }
+
+std::string processTextFile(const std::string& filename) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        perror("Error opening file");
+        return "";
     }
 
+    std::string result;
+    result.reserve(file.size() + 1);
+
+    const char* data = file.data();
+    forEachLetterRun(data, file.size(), [&](size_t begin, size_t end) {
+        size_t offset = result.size();
+        result.append(data + begin, end - begin);
+        lowerAscii(&result[offset], &result[offset], end - begin);
+        result += ' ';
+    });
+
     return result;
 }
 
@@ -140,6 +727,21 @@ void printList(WordNode* head) {
     std::cout << std::endl;
 }
 
+std::vector<int> tokenizeTextFile(const std::string& filename, WordTable& table) {
+    std::vector<int> tokens;
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        perror("Error opening file");
+        return tokens;
+    }
+
+    tokens.reserve(file.size() / 6);
+    forEachWord(file.data(), file.size(), [&](std::string_view word) {
+        tokens.push_back(table.addWord(word));
+    });
+    return tokens;
+}
+
 void populateWordTable(WordNode* head, WordTable& table) {
     if (!head) return;
 
@@ -165,13 +767,152 @@ void buildGraph(WordNode* head, Graph& graph, WordTable& table) {
         int id1 = table.getIndex(temp1->word);
         int id2 = table.getIndex(temp2->word);
         
-        if (id1 != -1 && id2 != -1 && id1 < graph.numVertices && id2 < graph.numVertices) {
-            graph.adjacencyMatrix[id1][id2]++;
+        if (id1 != -1 && id2 != -1) {
+            graph.addEdge(id1, id2);
         }
         
         temp1 = temp1->next;
         temp2 = temp2 ? temp2->next : nullptr;
     }
+
+    graph.finalize();
+}
+
+void buildGraph(const std::vector<int>& tokens, Graph& graph) {
+    for (size_t i = 1; i < tokens.size(); i++) {
+        graph.addEdge(tokens[i - 1], tokens[i]);
+    }
+    graph.finalize();
+}
+
+GraphBuilder::GraphBuilder(WordTable& table) : table(table), first(-1), last(-1) {}
+
+void GraphBuilder::addWord(std::string_view word) {
+    int id = table.addWord(word);
+    if (last != -1) {
+        edges[(static_cast<uint64_t>(last) << 32) | static_cast<uint32_t>(id)]++;
+    } else {
+        first = id;
+    }
+    last = id;
+}
+
+void GraphBuilder::addText(const char* data, size_t size) {
+    // Letters at the start continue a word cut off by the previous chunk
+    size_t begin = 0;
+    while (begin < size && isAsciiLetter(data[begin])) {
+        begin++;
+    }
+    partialWord.append(data, begin);
+    if (begin == size) return;
+    endText();
+
+    // Hold back a trailing word that may continue in the next chunk
+    size_t end = size;
+    while (end > begin && isAsciiLetter(data[end - 1])) {
+        end--;
+    }
+    forEachWord(data + begin, end - begin, [this](std::string_view word) { addWord(word); });
+    partialWord.assign(data + end, size - end);
+}
+
+void GraphBuilder::endText() {
+    if (partialWord.empty()) return;
+    std::string word;
+    word.swap(partialWord);
+    forEachWord(word.data(), word.size(), [this](std::string_view w) { addWord(w); });
+}
+
+Graph GraphBuilder::finish() {
+    endText();
+    Graph graph(table.size());
+    for (const auto& edge : edges) {
+        graph.addEdge(edge.first >> 32, edge.first & 0xFFFFFFFFu, edge.second);
+    }
+    graph.finalize();
+    edges.clear();
+    first = last = -1;
+    return graph;
+}
+
+const std::unordered_map<uint64_t, int>& GraphBuilder::edgeCounts() const { return edges; }
+
+int GraphBuilder::firstWord() const { return first; }
+
+int GraphBuilder::lastWord() const { return last; }
+
+Graph buildGraphParallel(const char* data, size_t size, WordTable& table, int num_threads) {
+    if (num_threads <= 0) {
+        // Small inputs are not worth a thread per core
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+        num_threads = static_cast<int>(std::min<size_t>(num_threads, size / (1 << 20) + 1));
+    }
+
+    // Split at letter-run boundaries so no word straddles two chunks
+    std::vector<size_t> bounds(num_threads + 1, size);
+    bounds[0] = 0;
+    for (int t = 1; t < num_threads; t++) {
+        size_t pos = std::max(bounds[t - 1], size / num_threads * t);
+        while (pos < size && pos > 0 && isAsciiLetter(data[pos - 1]) && isAsciiLetter(data[pos])) {
+            pos++;
+        }
+        bounds[t] = pos;
+    }
+
+    // Each thread interns into its own table with its own builder
+    std::vector<WordTable> tables(num_threads);
+    std::vector<GraphBuilder> builders;
+    builders.reserve(num_threads);
+    for (int t = 0; t < num_threads; t++) {
+        builders.emplace_back(tables[t]);
+    }
+    auto buildChunk = [&](int t) {
+        builders[t].addText(data + bounds[t], bounds[t + 1] - bounds[t]);
+        builders[t].endText();
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < num_threads; t++) {
+        workers.emplace_back(buildChunk, t);
+    }
+    buildChunk(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Intern chunk vocabularies in chunk order so ids follow first occurrence
+    std::vector<std::vector<int>> remap(num_threads);
+    for (int t = 0; t < num_threads; t++) {
+        remap[t].resize(tables[t].size());
+        for (size_t i = 0; i < tables[t].size(); i++) {
+            remap[t][i] = table.addWord(tables[t].word(i));
+        }
+    }
+
+    Graph graph(table.size());
+    int previous = -1;
+    for (int t = 0; t < num_threads; t++) {
+        const GraphBuilder& chunk = builders[t];
+        if (chunk.firstWord() == -1) continue;
+        for (const auto& edge : chunk.edgeCounts()) {
+            graph.addEdge(remap[t][edge.first >> 32], remap[t][edge.first & 0xFFFFFFFFu], edge.second);
+        }
+        // The one bigram spanning the boundary with the previous chunk
+        if (previous != -1) {
+            graph.addEdge(previous, remap[t][chunk.firstWord()]);
+        }
+        previous = remap[t][chunk.lastWord()];
+    }
+    graph.finalize();
+    return graph;
+}
+
+Graph buildGraphFromFile(const std::string& filename, WordTable& table, int num_threads) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        perror("Error opening file");
+        return Graph(table.size());
+    }
+    return buildGraphParallel(file.data(), file.size(), table, num_threads);
 }
 
 void exportToDot(const Graph& graph, const WordTable& table, const std::string& filename) {
@@ -186,12 +927,9 @@ void exportToDot(const Graph& graph, const WordTable& table, const std::string&
     file << "  node [shape=circle];\n";
 
     for (int i = 0; i < graph.numVertices; i++) {
-        for (int j = 0; j < graph.numVertices; j++) {
-            int weight = graph.adjacencyMatrix[i][j];
-            if (weight != 0) {
-                file << "  \"" << table.words[i] << "\" -> \"" << table.words[j] 
-                     << "\" [label=\"" << weight << "\"];\n";
-            }
+        for (int e = graph.rowOffsets[i]; e < graph.rowOffsets[i + 1]; e++) {
+            file << "  \"" << table.word(i) << "\" -> \"" << table.word(graph.columnIndices[e]) 
+                 << "\" [label=\"" << graph.edgeWeights[e] << "\"];\n";
         }
     }
 
@@ -203,20 +941,27 @@ void printAdjacencyMatrix(const Graph& graph, const WordTable& table) {
     
     std::cout << "    ";
     for (int j = 0; j < graph.numVertices; j++) {
-        std::cout << std::left << std::setw(5) << table.words[j] << " ";
+        std::cout << std::left << std::setw(5) << table.word(j) << " ";
     }
     std::cout << std::endl;
     
+    std::vector<int> row(graph.numVertices, 0);
     for (int i = 0; i < graph.numVertices; i++) {
-        std::cout << std::left << std::setw(5) << table.words[i] << " ";
+        for (int e = graph.rowOffsets[i]; e < graph.rowOffsets[i + 1]; e++) {
+            row[graph.columnIndices[e]] = graph.edgeWeights[e];
+        }
+        std::cout << std::left << std::setw(5) << table.word(i) << " ";
         for (int j = 0; j < graph.numVertices; j++) {
-            std::cout << std::left << std::setw(5) << graph.adjacencyMatrix[i][j] << " ";
+            std::cout << std::left << std::setw(5) << row[j] << " ";
         }
         std::cout << std::endl;
+        for (int e = graph.rowOffsets[i]; e < graph.rowOffsets[i + 1]; e++) {
+            row[graph.columnIndices[e]] = 0;
+        }
     }
 }
 
-void findBridgeWords(const Graph& graph, const WordTable& table, const std::string& word1, const std::string& word2) {
+void findBridgeWords(const Graph& graph, const WordTable& table, std::string_view word1, std::string_view word2) {
     int id1 = table.getIndex(word1);
     int id2 = table.getIndex(word2);
 
@@ -231,20 +976,15 @@ void findBridgeWords(const Graph& graph, const WordTable& table, const std::stri
         return;
     }
 
-    std::vector<std::string> bridge_words;
-
-    for (int i = 0; i < graph.numVertices; i++) {
-        if (graph.adjacencyMatrix[id1][i] > 0 && graph.adjacencyMatrix[i][id2] > 0) {
-            bridge_words.push_back(table.words[i]);
-        }
-    }
+    std::vector<int> bridge_words;
+    bridgeWords(graph, id1, id2, bridge_words);
 
     if (bridge_words.empty()) {
         std::cout << "No bridge words from " << word1 << " to " << word2 << "!" << std::endl;
     } else {
         std::cout << "The bridge words from " << word1 << " to " << word2 << " are: ";
         for (size_t i = 0; i < bridge_words.size(); i++) {
-            std::cout << bridge_words[i];
+            std::cout << table.word(bridge_words[i]);
             if (i < bridge_words.size() - 2) {
                 std::cout << ", ";
             } else if (i == bridge_words.size() - 2) {
@@ -256,132 +996,1688 @@ void findBridgeWords(const Graph& graph, const WordTable& table, const std::stri
 }
 
 
-std::string selectRandomBridgeWord(const Graph& graph, const WordTable& table, int id1, int id2) {
-    std::vector<int> bridge_indices;
-    
-    for (int i = 0; i < graph.numVertices; i++) {
-        if (graph.adjacencyMatrix[id1][i] > 0 && graph.adjacencyMatrix[i][id2] > 0) {
-            bridge_indices.push_back(i);
-        }
-    }
-    
-    if (bridge_indices.empty()) {
-        return "";
+namespace {
+
+// First index in [from, n) with a[index] >= x, probing 1, 2, 4, ... ahead
+int gallop(const int* a, int from, int n, int x) {
+    int step = 1;
+    int low = from, high = from;
+    while (high < n && a[high] < x) {
+        low = high + 1;
+        high += step;
+        step *= 2;
     }
-    
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, bridge_indices.size() - 1);
-    
-    return table.words[bridge_indices[dis(gen)]];
+    return std::lower_bound(a + low, a + std::min(high, n), x) - a;
 }
 
-void generateNewText(const Graph& graph, const WordTable& table, const std::string& input_text) {
-    if (input_text.empty()) {
-        std::cout << "Empty input text." << std::endl;
+void intersectSorted(const int* a, int na, const int* b, int nb, std::vector<int>& out) {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (na == 0) return;
+    if (nb / na >= 16) {
+        int j = 0;
+        for (int i = 0; i < na && j < nb; i++) {
+            j = gallop(b, j, nb, a[i]);
+            if (j < nb && b[j] == a[i]) out.push_back(a[i]);
+        }
+        return;
+    }
+    int i = 0, j = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (b[j] < a[i]) {
+            j++;
+        } else {
+            out.push_back(a[i]);
+            i++;
+            j++;
+        }
+    }
+}
+
+}  // namespace
+
+void bridgeWords(const Graph& graph, int id1, int id2, std::vector<int>& bridges) {
+    bridges.clear();
+    int out_begin = graph.rowOffsets[id1];
+    int in_begin = graph.inOffsets[id2];
+    intersectSorted(graph.columnIndices.data() + out_begin, graph.rowOffsets[id1 + 1] - out_begin,
+                    graph.inSources.data() + in_begin, graph.inOffsets[id2 + 1] - in_begin, bridges);
+}
+
+BridgeWordIndex::BridgeWordIndex(const Graph& graph)
+    : graph(graph), words((graph.numVertices + 63) / 64),
+      outSlot(graph.numVertices, -1), inSlot(graph.numVertices, -1) {
+    auto build = [&](const std::vector<int>& offsets, const std::vector<int>& ends, std::vector<int>& slot,
+                     std::vector<uint64_t>& bits) {
+        int hubs = 0;
+        for (int u = 0; u < graph.numVertices; u++) {
+            if (static_cast<long long>(offsets[u + 1] - offsets[u]) * 32 >= graph.numVertices) {
+                slot[u] = hubs++;
+            }
+        }
+        bits.assign(static_cast<size_t>(hubs) * words, 0);
+        for (int u = 0; u < graph.numVertices; u++) {
+            if (slot[u] == -1) continue;
+            uint64_t* row = bits.data() + static_cast<size_t>(slot[u]) * words;
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                row[ends[e] >> 6] |= uint64_t(1) << (ends[e] & 63);
+            }
+        }
+    };
+    build(graph.rowOffsets, graph.columnIndices, outSlot, outBits);
+    build(graph.inOffsets, graph.inSources, inSlot, inBits);
+}
+
+void BridgeWordIndex::find(int id1, int id2, std::vector<int>& bridges) const {
+    int out_hub = outSlot[id1], in_hub = inSlot[id2];
+    if (out_hub == -1 && in_hub == -1) {
+        bridgeWords(graph, id1, id2, bridges);
         return;
     }
     
-    std::string processed_input;
-    processed_input.reserve(input_text.size());
-    
-    for (char c : input_text) {
-        if (isalpha(c)) {
-            processed_input += toLower(c);
-        } else if (!processed_input.empty() && processed_input.back() != ' ') {
-            processed_input += ' ';
+    bridges.clear();
+    if (out_hub != -1 && in_hub != -1) {
+        const uint64_t* a = outBits.data() + static_cast<size_t>(out_hub) * words;
+        const uint64_t* b = inBits.data() + static_cast<size_t>(in_hub) * words;
+        for (int w = 0; w < words; w++) {
+            for (uint64_t both = a[w] & b[w]; both; both &= both - 1) {
+                bridges.push_back(w * 64 + lowestSetBit(both));
+            }
         }
+        return;
+    }
+    // Test the short row's entries against the hub's bitset
+    const uint64_t* hub;
+    const int* row;
+    int count;
+    if (out_hub != -1) {
+        hub = outBits.data() + static_cast<size_t>(out_hub) * words;
+        row = graph.inSources.data() + graph.inOffsets[id2];
+        count = graph.inOffsets[id2 + 1] - graph.inOffsets[id2];
+    } else {
+        hub = inBits.data() + static_cast<size_t>(in_hub) * words;
+        row = graph.columnIndices.data() + graph.rowOffsets[id1];
+        count = graph.rowOffsets[id1 + 1] - graph.rowOffsets[id1];
+    }
+    for (int i = 0; i < count; i++) {
+        if (hub[row[i] >> 6] >> (row[i] & 63) & 1) bridges.push_back(row[i]);
+    }
+}
+
+namespace {
+
+std::string pickBridgeWord(const WordTable& table, const std::vector<int>& bridges) {
+    if (bridges.empty()) {
+        return "";
+    }
+    // Per thread, so concurrent callers do not share generator state
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> dis(0, bridges.size() - 1);
+    return std::string(table.word(bridges[dis(gen)]));
+}
+
+}  // namespace
+
+std::string selectRandomBridgeWord(const Graph& graph, const WordTable& table, int id1, int id2) {
+    // Reused across calls on the same thread, like the generator
+    thread_local std::vector<int> bridges;
+    bridgeWords(graph, id1, id2, bridges);
+    return pickBridgeWord(table, bridges);
+}
+
+std::string selectRandomBridgeWord(const BridgeWordIndex& index, const WordTable& table, int id1, int id2) {
+    thread_local std::vector<int> bridges;
+    index.find(id1, id2, bridges);
+    return pickBridgeWord(table, bridges);
+}
+
+void generateNewText(const Graph& graph, const WordTable& table, const std::string& input_text) {
+    if (input_text.empty()) {
+        std::cout << "Empty input text." << std::endl;
+        return;
     }
     
-    WordNode* input_list = sentenceToList(processed_input);
-    if (!input_list) {
+    std::vector<std::pair<size_t, size_t>> words;
+    forEachLetterRun(input_text.data(), input_text.size(), [&](size_t begin, size_t end) {
+        words.push_back(std::make_pair(begin, end));
+    });
+    if (words.empty()) {
         std::cout << "No valid words in input text." << std::endl;
         return;
     }
     
+    std::string lowered(input_text.size(), ' ');
+    lowerAscii(&lowered[0], input_text.data(), input_text.size());
+    
     std::string new_text;
     new_text.reserve(input_text.size() * 2);
     
-    WordNode* current = input_list;
-    WordNode* next = current->next;
     size_t original_pos = 0;
+    std::string_view lowered_view(lowered);
+    auto lookup = [&](size_t w) {
+        return table.getIndex(lowered_view.substr(words[w].first, words[w].second - words[w].first));
+    };
+    int id2 = lookup(0);
     
-    while (current && next) {
-        while (original_pos < input_text.size() && !isalpha(input_text[original_pos])) {
-            new_text += input_text[original_pos++];
-        }
-        
-        size_t word_start = original_pos;
-        while (original_pos < input_text.size() && isalpha(input_text[original_pos])) {
-            new_text += input_text[original_pos++];
-        }
-        
-        std::string lower_current = current->word;
-        std::string lower_next = next->word;
+    for (size_t w = 0; w + 1 < words.size(); w++) {
+        size_t word_start = words[w].first;
+        new_text.append(input_text, original_pos, words[w].second - original_pos);
+        original_pos = words[w].second;
         
-        int id1 = table.getIndex(lower_current);
-        int id2 = table.getIndex(lower_next);
+        int id1 = id2;
+        id2 = lookup(w + 1);
         
         if (id1 != -1 && id2 != -1) {
             std::string bridge_word = selectRandomBridgeWord(graph, table, id1, id2);
             if (!bridge_word.empty()) {
                 new_text += ' ';
                 
-                if (word_start < input_text.size() && isupper(input_text[word_start])) {
+                if (isupper(input_text[word_start])) {
                     bridge_word[0] = toupper(bridge_word[0]);
                 }
                 
                 new_text += bridge_word;
             }
         }
+    }
+    
+    new_text.append(input_text, original_pos, std::string::npos);
+    
+    std::cout << "Generated new text: " << new_text << std::endl;
+}
+
+namespace {
+
+// Dijkstra over one CSR direction; labels and parents land in workspace
+void dijkstraOver(const std::vector<int>& offsets, const std::vector<int>& ends, const std::vector<int>& weights,
+                  int source, SearchWorkspace& workspace, int target) {
+    workspace.reset(offsets.size() - 1);
+    
+    // Ties pop the smaller vertex id first, like a linear min-scan would
+    workspace.label(source, 0, -1);
+    workspace.push(0, source);
+    
+    while (!workspace.empty()) {
+        std::pair<int, int> top = workspace.top();
+        workspace.pop();
+        int u = top.second;
+        if (top.first != workspace.distance(u)) continue;
+        if (u == target) break;
         
-        current = next;
-        next = next->next;
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            int v = ends[e];
+            int candidate = top.first + weights[e];
+            if (candidate < workspace.distance(v)) {
+                workspace.label(v, candidate, u);
+                workspace.push(candidate, v);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+SearchWorkspace::SearchWorkspace() : epoch(0) {}
+
+void SearchWorkspace::reset(int num_vertices) {
+    heap.clear();
+    if (static_cast<int>(stamp.size()) != num_vertices) {
+        stamp.assign(num_vertices, 0);
+        settledStamp.assign(num_vertices, 0);
+        dist.resize(num_vertices);
+        parents.resize(num_vertices);
+        epoch = 0;
+    }
+    // Clear the stamps only when the epoch counter wraps
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        std::fill(settledStamp.begin(), settledStamp.end(), 0);
+        epoch = 1;
+    }
+}
+
+PathCounts::PathCounts() : epoch(0) {}
+
+void PathCounts::reset(int num_vertices) {
+    if (static_cast<int>(stamp.size()) != num_vertices) {
+        stamp.assign(num_vertices, 0);
+        counts.resize(num_vertices);
+        epoch = 0;
+    }
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+}
+
+void SearchWorkspace::copyDistances(std::vector<int>& out) const {
+    out.resize(stamp.size());
+    for (size_t v = 0; v < stamp.size(); v++) {
+        out[v] = distance(v);
+    }
+}
+
+void SearchWorkspace::copyParents(std::vector<int>& out) const {
+    out.resize(stamp.size());
+    for (size_t v = 0; v < stamp.size(); v++) {
+        out[v] = parent(v);
+    }
+}
+
+void dijkstra(const Graph& graph, int source, std::vector<int>& dist, std::vector<int>& prev, int target) {
+    thread_local SearchWorkspace workspace;
+    dijkstraOver(graph.rowOffsets, graph.columnIndices, graph.edgeWeights, source, workspace, target);
+    workspace.copyDistances(dist);
+    workspace.copyParents(prev);
+}
+
+int dijkstra(const Graph& graph, int source, int target, SearchWorkspace& workspace) {
+    dijkstraOver(graph.rowOffsets, graph.columnIndices, graph.edgeWeights, source, workspace, target);
+    return target == -1 ? INT_MAX : workspace.distance(target);
+}
+
+ThreadPool::ThreadPool(int num_threads) : current(nullptr), generation(0), pending(0), stopping(false) {
+    if (num_threads <= 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int t = 1; t < num_threads; t++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, t);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::size() const { return workers.size() + 1; }
+
+void ThreadPool::run(const std::function<void(int)>& task) {
+    std::lock_guard<std::mutex> serial(dispatch);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = &task;
+        pending = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    task(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return pending == 0; });
+}
+
+void ThreadPool::workerLoop(int thread) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+        const std::function<void(int)>& task = *current;
+        lock.unlock();
+        task(thread);
+        lock.lock();
+        if (--pending == 0) finished.notify_one();
+    }
+}
+
+namespace {
+
+inline bool relaxDistance(std::atomic<int>& dist, int candidate) {
+    int seen = dist.load(std::memory_order_relaxed);
+    while (candidate < seen) {
+        if (dist.compare_exchange_weak(seen, candidate, std::memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+void deltaStepping(const Graph& graph, int source, std::vector<int>& dist, std::vector<int>& prev,
+                   ThreadPool& pool, int delta) {
+    thread_local DeltaSteppingWorkspace workspace;
+    deltaStepping(graph, source, dist, prev, pool, workspace, delta);
+}
+
+void deltaStepping(const Graph& graph, int source, std::vector<int>& dist, std::vector<int>& prev,
+                   ThreadPool& pool, DeltaSteppingWorkspace& workspace, int delta) {
+    int n = graph.numVertices;
+    if (delta <= 0) {
+        // Word graph weights are small bigram counts; one bucket per mean weight
+        long long total = 0;
+        for (int w : graph.edgeWeights) total += w;
+        delta = graph.numEdges() ? std::max<long long>(1, total / graph.numEdges()) : 1;
+    }
+    
+    std::vector<std::atomic<int>>& tentative = workspace.tentative;
+    if (static_cast<int>(tentative.size()) != n) {
+        std::vector<std::atomic<int>>(n).swap(tentative);
+    }
+    for (auto& d : tentative) d.store(INT_MAX, std::memory_order_relaxed);
+    tentative[source].store(0, std::memory_order_relaxed);
+    
+    // Buckets are maintained serially; only edge relaxation runs in parallel.
+    // Every bucket is left empty, so only the first one needs seeding.
+    std::vector<std::vector<int>>& buckets = workspace.buckets;
+    if (buckets.empty()) buckets.resize(1);
+    buckets[0].push_back(source);
+    size_t used = 1;
+    std::vector<int>& queued_in = workspace.queuedIn;
+    queued_in.assign(n, -1);
+    queued_in[source] = 0;
+    int threads = pool.size();
+    std::vector<std::vector<int>>& improved = workspace.improved;
+    if (static_cast<int>(improved.size()) < threads) improved.resize(threads);
+    
+    auto distanceOf = [&](int v) { return tentative[v].load(std::memory_order_relaxed); };
+    // Relax light (w <= delta) or heavy edges out of every vertex in frontier
+    auto relaxAll = [&](const std::vector<int>& frontier, bool light) {
+        auto work = [&](int t, int parts) {
+            size_t begin = frontier.size() * t / parts;
+            size_t end = frontier.size() * (t + 1) / parts;
+            for (size_t i = begin; i < end; i++) {
+                int u = frontier[i];
+                int du = distanceOf(u);
+                for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+                    if ((graph.edgeWeights[e] <= delta) != light) continue;
+                    int v = graph.columnIndices[e];
+                    if (relaxDistance(tentative[v], du + graph.edgeWeights[e])) {
+                        improved[t].push_back(v);
+                    }
+                }
+            }
+        };
+        // Small frontiers are cheaper to relax than to hand out
+        if (threads == 1 || frontier.size() < 64) {
+            work(0, 1);
+        } else {
+            pool.run([&](int t) { work(t, threads); });
+        }
+        for (std::vector<int>& list : improved) {
+            for (int v : list) {
+                int b = distanceOf(v) / delta;
+                if (queued_in[v] == b) continue;
+                queued_in[v] = b;
+                if (b >= static_cast<int>(used)) used = b + 1;
+                if (used > buckets.size()) buckets.resize(used);
+                buckets[b].push_back(v);
+            }
+            list.clear();
+        }
+    };
+    
+    std::vector<int>& frontier = workspace.frontier;
+    std::vector<int>& settled = workspace.settled;
+    for (size_t i = 0; i < used; i++) {
+        settled.clear();
+        while (!buckets[i].empty()) {
+            frontier.clear();
+            for (int v : buckets[i]) {
+                // Skip entries left behind after v moved to a lower bucket
+                if (queued_in[v] != static_cast<int>(i)) continue;
+                queued_in[v] = -1;
+                frontier.push_back(v);
+            }
+            buckets[i].clear();
+            settled.insert(settled.end(), frontier.begin(), frontier.end());
+            relaxAll(frontier, true);
+        }
+        std::sort(settled.begin(), settled.end());
+        settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+        relaxAll(settled, false);
+    }
+    
+    dist.resize(n);
+    for (int v = 0; v < n; v++) {
+        dist[v] = distanceOf(v);
+    }
+    
+    // Pick the parent dijkstra would: the tight in-neighbour that comes first
+    // in (distance, id) order, so printed paths do not depend on the engine
+    prev.assign(n, -1);
+    pool.run([&](int t) {
+        for (int v = t; v < n; v += threads) {
+            if (v == source || dist[v] == INT_MAX) continue;
+            for (int e = graph.inOffsets[v]; e < graph.inOffsets[v + 1]; e++) {
+                int u = graph.inSources[e];
+                if (dist[u] == INT_MAX || dist[u] + graph.inWeights[e] != dist[v]) continue;
+                if (prev[v] == -1 || dist[u] < dist[prev[v]]) prev[v] = u;
+            }
+        }
+    });
+}
+
+int bidirectionalDijkstra(const Graph& graph, int source, int target, QueryContext& context) {
+    SearchWorkspace& forward = context.forward;
+    SearchWorkspace& backward = context.backward;
+    forward.reset(graph.numVertices);
+    backward.reset(graph.numVertices);
+    forward.label(source, 0, -1);
+    backward.label(target, 0, -1);
+    forward.push(0, source);
+    backward.push(0, target);
+    long long best = source == target ? 0 : LLONG_MAX;
+    
+    auto drop_stale = [](SearchWorkspace& side) {
+        while (!side.empty() && side.top().first != side.distance(side.top().second)) {
+            side.pop();
+        }
+    };
+    
+    for (;;) {
+        drop_stale(forward);
+        drop_stale(backward);
+        if (forward.empty() || backward.empty()) break;
+        
+        // Stop only once the frontiers strictly pass the best meeting, so
+        // every vertex on any tied shortest path is settled on some side
+        long long top_sum = static_cast<long long>(forward.top().first) + backward.top().first;
+        if (top_sum > best) break;
+        
+        bool go_forward = forward.heapSize() <= backward.heapSize();
+        SearchWorkspace& side = go_forward ? forward : backward;
+        const SearchWorkspace& other = go_forward ? backward : forward;
+        const std::vector<int>& offsets = go_forward ? graph.rowOffsets : graph.inOffsets;
+        const std::vector<int>& ends = go_forward ? graph.columnIndices : graph.inSources;
+        const std::vector<int>& weights = go_forward ? graph.edgeWeights : graph.inWeights;
+        
+        int u = side.top().second;
+        int du = side.top().first;
+        side.pop();
+        side.settle(u);
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            int v = ends[e];
+            int candidate = du + weights[e];
+            if (candidate < side.distance(v)) {
+                side.label(v, candidate, u);
+                side.push(candidate, v);
+            }
+            if (other.distance(v) != INT_MAX) {
+                best = std::min(best, static_cast<long long>(side.distance(v)) + other.distance(v));
+            }
+        }
+    }
+    return best == LLONG_MAX ? INT_MAX : static_cast<int>(best);
+}
+
+int bidirectionalDijkstra(const Graph& graph, int source, int target, std::vector<int>& dist) {
+    thread_local QueryContext context;
+    int distance = bidirectionalDijkstra(graph, source, target, context);
+    
+    // Forward labels where settled, otherwise distance minus the backward
+    // label, which is a lower bound and exact on shortest-path vertices
+    dist.assign(graph.numVertices, INT_MAX);
+    if (distance == INT_MAX) return INT_MAX;
+    for (int v = 0; v < graph.numVertices; v++) {
+        if (context.forward.settled(v)) {
+            dist[v] = context.forward.distance(v);
+        } else if (context.backward.settled(v) && context.backward.distance(v) <= distance) {
+            dist[v] = distance - context.backward.distance(v);
+        }
+    }
+    dist[source] = 0;
+    dist[target] = distance;
+    return distance;
+}
+
+LandmarkIndex::LandmarkIndex(const Graph& graph, int num_landmarks) : graph(graph) {
+    int n = graph.numVertices;
+    num_landmarks = std::max(0, std::min(num_landmarks, n));
+    fromLandmark.reserve(static_cast<size_t>(n) * num_landmarks);
+    toLandmark.reserve(static_cast<size_t>(n) * num_landmarks);
+    
+    // Start at the busiest word, then repeatedly take the word farthest
+    // from every landmark chosen so far (farthest-point selection)
+    std::vector<int> nearest(n, INT_MAX);
+    SearchWorkspace workspace;
+    std::vector<int> forward, backward;
+    std::vector<int> from_rows, to_rows;
+    for (int k = 0; k < num_landmarks; k++) {
+        int next = -1;
+        for (int v = 0; v < n; v++) {
+            if (nearest[v] == 0) continue;
+            if (k == 0) {
+                int degree = graph.outDegree(v) + graph.inOffsets[v + 1] - graph.inOffsets[v];
+                if (next == -1 || degree > graph.outDegree(next) + graph.inOffsets[next + 1] - graph.inOffsets[next]) {
+                    next = v;
+                }
+            } else if (nearest[v] != INT_MAX && (next == -1 || nearest[v] > nearest[next])) {
+                next = v;
+            }
+        }
+        if (next == -1) break;
+        
+        landmarkIds.push_back(next);
+        dijkstraOver(graph.rowOffsets, graph.columnIndices, graph.edgeWeights, next, workspace, -1);
+        workspace.copyDistances(forward);
+        dijkstraOver(graph.inOffsets, graph.inSources, graph.inWeights, next, workspace, -1);
+        workspace.copyDistances(backward);
+        from_rows.insert(from_rows.end(), forward.begin(), forward.end());
+        to_rows.insert(to_rows.end(), backward.begin(), backward.end());
+        for (int v = 0; v < n; v++) {
+            nearest[v] = std::min(nearest[v], forward[v]);
+        }
+    }
+    
+    // Store vertex-major so one query touches one run per vertex
+    int count = landmarkIds.size();
+    fromLandmark.resize(static_cast<size_t>(n) * count);
+    toLandmark.resize(static_cast<size_t>(n) * count);
+    for (int k = 0; k < count; k++) {
+        for (int v = 0; v < n; v++) {
+            fromLandmark[static_cast<size_t>(v) * count + k] = from_rows[static_cast<size_t>(k) * n + v];
+            toLandmark[static_cast<size_t>(v) * count + k] = to_rows[static_cast<size_t>(k) * n + v];
+        }
+    }
+}
+
+const std::vector<int>& LandmarkIndex::landmarks() const { return landmarkIds; }
+
+int LandmarkIndex::lowerBound(int from, int to) const {
+    // d(from, to) >= d(L, to) - d(L, from) and >= d(from, L) - d(to, L).
+    // A finite term paired with an infinite one proves to is unreachable.
+    size_t count = landmarkIds.size();
+    const int* from_l = fromLandmark.data() + from * count;
+    const int* to_l = fromLandmark.data() + to * count;
+    const int* from_r = toLandmark.data() + from * count;
+    const int* to_r = toLandmark.data() + to * count;
+    int bound = 0;
+    for (size_t k = 0; k < count; k++) {
+        if (from_l[k] != INT_MAX) {
+            if (to_l[k] == INT_MAX) return INT_MAX;
+            bound = std::max(bound, to_l[k] - from_l[k]);
+        }
+        if (to_r[k] != INT_MAX) {
+            if (from_r[k] == INT_MAX) return INT_MAX;
+            bound = std::max(bound, from_r[k] - to_r[k]);
+        }
+    }
+    return bound;
+}
+
+int LandmarkIndex::query(int source, int target, SearchWorkspace& workspace) const {
+    workspace.reset(graph.numVertices);
+    if (lowerBound(source, target) == INT_MAX) return INT_MAX;
+    
+    // A* with the landmark bound; keep going while the smallest key could
+    // still tie the best distance so every shortest path is settled
+    workspace.label(source, 0, -1);
+    workspace.push(lowerBound(source, target), source);
+    while (!workspace.empty()) {
+        std::pair<int, int> top = workspace.top();
+        workspace.pop();
+        int u = top.second;
+        if (workspace.settled(u)) continue;
+        if (workspace.settled(target) && top.first > workspace.distance(target)) break;
+        workspace.settle(u);
+        
+        int du = workspace.distance(u);
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            int v = graph.columnIndices[e];
+            int candidate = du + graph.edgeWeights[e];
+            if (candidate < workspace.distance(v)) {
+                int h = lowerBound(v, target);
+                if (h == INT_MAX) continue;
+                workspace.label(v, candidate, u);
+                workspace.push(candidate + h, v);
+            }
+        }
+    }
+    return workspace.settled(target) ? workspace.distance(target) : INT_MAX;
+}
+
+int LandmarkIndex::query(int source, int target, std::vector<int>& dist) const {
+    thread_local SearchWorkspace workspace;
+    int distance = query(source, target, workspace);
+    dist.assign(graph.numVertices, INT_MAX);
+    for (int v = 0; v < graph.numVertices; v++) {
+        if (workspace.settled(v)) dist[v] = workspace.distance(v);
+    }
+    return distance;
+}
+
+namespace {
+
+struct ChEdge {
+    int other;
+    int weight;
+    int middle;  // contracted vertex a shortcut skips, or -1
+};
+
+// Working state while contracting; in[v] holds edges into v keyed by source.
+// Edge positions within each row are hashed, so hub rows are never scanned
+// to find or remove one neighbour.
+class ChBuilder {
+public:
+    explicit ChBuilder(const Graph& graph)
+        : n(graph.numVertices), out(n), in(n),
+          deletedNeighbors(n, 0), witnessDist(n, INT_MAX), need(n, -1) {
+        outPos.reserve(graph.numEdges());
+        inPos.reserve(graph.numEdges());
+        for (int u = 0; u < n; u++) {
+            for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+                int v = graph.columnIndices[e];
+                if (v == u) continue;
+                addOrLower(out, outPos, u, v, graph.edgeWeights[e], -1);
+                addOrLower(in, inPos, v, u, graph.edgeWeights[e], -1);
+            }
+        }
+    }
+
+    // Contracts every vertex; fills rank and moves each vertex's remaining
+    // edges into up (to higher ranks) and down (from higher ranks)
+    void contractAll(std::vector<int>& rank, std::vector<std::vector<ChEdge>>& up,
+                     std::vector<std::vector<ChEdge>>& down) {
+        typedef std::pair<int, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        // Seed with the in*out shortcut bound; witness searches around hubs
+        // are too costly to run for every vertex up front. Hub products can
+        // pass INT_MAX, so the bound is taken in 64 bits and clamped.
+        for (int v = 0; v < n; v++) {
+            long long in_degree = in[v].size(), out_degree = out[v].size();
+            long long bound = in_degree * out_degree - in_degree - out_degree;
+            queue.push(Entry(static_cast<int>(std::min<long long>(bound, INT_MAX)), v));
+        }
+        
+        // Lazy updates: re-evaluate the minimum and contract it only if it
+        // is still no worse than the next candidate
+        rank.assign(n, 0);
+        up.assign(n, std::vector<ChEdge>());
+        down.assign(n, std::vector<ChEdge>());
+        int order = 0;
+        while (!queue.empty()) {
+            int v = queue.top().second;
+            queue.pop();
+            // priority() leaves v's shortcuts in shortcuts, still valid here
+            int current = priority(v);
+            if (!queue.empty() && current > queue.top().first) {
+                queue.push(Entry(current, v));
+                continue;
+            }
+            for (const Shortcut& shortcut : shortcuts) {
+                addOrLower(out, outPos, shortcut.from, shortcut.to, shortcut.weight, v);
+                addOrLower(in, inPos, shortcut.to, shortcut.from, shortcut.weight, v);
+            }
+            rank[v] = order++;
+            for (const ChEdge& e : out[v]) {
+                deletedNeighbors[e.other]++;
+                removeEdge(in, inPos, e.other, v);
+                outPos.erase(edgeKey(v, e.other));
+            }
+            for (const ChEdge& e : in[v]) {
+                deletedNeighbors[e.other]++;
+                removeEdge(out, outPos, e.other, v);
+                inPos.erase(edgeKey(v, e.other));
+            }
+            up[v].swap(out[v]);
+            down[v].swap(in[v]);
+        }
+    }
+
+private:
+    // Witness searches stop after either limit; a missed witness only costs
+    // a redundant shortcut
+    static const int WITNESS_SETTLE_LIMIT = 50;
+    static const int WITNESS_EDGE_LIMIT = 1000;
+
+    struct Shortcut {
+        int from;
+        int to;
+        int weight;
+    };
+
+    int n;
+    std::vector<std::vector<ChEdge>> out;
+    std::vector<std::vector<ChEdge>> in;
+    std::unordered_map<uint64_t, int> outPos;  // (v, other) -> index in out[v]
+    std::unordered_map<uint64_t, int> inPos;
+    std::vector<int> deletedNeighbors;
+    std::vector<int> witnessDist;
+    std::vector<int> need;  // pending targets: longest path that still counts as a witness, else -1
+    std::vector<int> touched;
+    std::vector<std::pair<int, int>> witnessHeap;
+    std::vector<Shortcut> shortcuts;
+
+    int priority(int v) {
+        findShortcuts(v);
+        int edges = out[v].size() + in[v].size();
+        return static_cast<int>(shortcuts.size()) - edges + deletedNeighbors[v];
+    }
+
+    static uint64_t edgeKey(int v, int other) {
+        return static_cast<uint64_t>(v) << 32 | static_cast<uint32_t>(other);
+    }
+
+    static void removeEdge(std::vector<std::vector<ChEdge>>& rows, std::unordered_map<uint64_t, int>& pos,
+                           int v, int other) {
+        auto it = pos.find(edgeKey(v, other));
+        if (it == pos.end()) return;
+        std::vector<ChEdge>& edges = rows[v];
+        int i = it->second;
+        pos.erase(it);
+        if (i + 1 != static_cast<int>(edges.size())) {
+            edges[i] = edges.back();
+            pos[edgeKey(v, edges[i].other)] = i;
+        }
+        edges.pop_back();
+    }
+
+    static void addOrLower(std::vector<std::vector<ChEdge>>& rows, std::unordered_map<uint64_t, int>& pos,
+                           int v, int other, int weight, int middle) {
+        auto inserted = pos.emplace(edgeKey(v, other), rows[v].size());
+        if (inserted.second) {
+            rows[v].push_back(ChEdge{other, weight, middle});
+            return;
+        }
+        ChEdge& e = rows[v][inserted.first->second];
+        if (weight < e.weight) {
+            e.weight = weight;
+            e.middle = middle;
+        }
+    }
+
+    // Bounded Dijkstra from source avoiding the vertex being contracted. It
+    // stops early once every pending target has a path no longer than its
+    // need; tentative distances are real paths, so they count as witnesses.
+    void witnessSearch(int source, int skip, int limit, int pending) {
+        int budget = WITNESS_EDGE_LIMIT;
+        witnessHeap.clear();
+        witnessDist[source] = 0;
+        touched.push_back(source);
+        witnessHeap.push_back(std::make_pair(0, source));
+        int settled = 0;
+        while (!witnessHeap.empty() && pending > 0 && settled < WITNESS_SETTLE_LIMIT) {
+            std::pop_heap(witnessHeap.begin(), witnessHeap.end(), std::greater<std::pair<int, int>>());
+            std::pair<int, int> top = witnessHeap.back();
+            witnessHeap.pop_back();
+            int u = top.second;
+            if (top.first != witnessDist[u]) continue;
+            if (top.first > limit) break;
+            settled++;
+            for (const ChEdge& e : out[u]) {
+                if (--budget < 0) return;
+                if (e.other == skip) continue;
+                int candidate = top.first + e.weight;
+                if (candidate <= limit && candidate < witnessDist[e.other]) {
+                    if (witnessDist[e.other] == INT_MAX) touched.push_back(e.other);
+                    witnessDist[e.other] = candidate;
+                    if (candidate <= need[e.other]) {
+                        need[e.other] = -1;
+                        pending--;
+                    }
+                    witnessHeap.push_back(std::make_pair(candidate, e.other));
+                    std::push_heap(witnessHeap.begin(), witnessHeap.end(), std::greater<std::pair<int, int>>());
+                }
+            }
+        }
+    }
+
+    // Path u -> h -> x avoiding skip, probing the shorter row against the
+    // other endpoint's hashed row
+    bool twoHopWitness(int u, int x, int skip, int weight) const {
+        if (out[u].size() <= in[x].size()) {
+            for (const ChEdge& first : out[u]) {
+                if (first.other == skip || first.weight >= weight) continue;
+                auto second = inPos.find(edgeKey(x, first.other));
+                if (second != inPos.end() && first.weight + in[x][second->second].weight <= weight) return true;
+            }
+        } else {
+            for (const ChEdge& second : in[x]) {
+                if (second.other == skip || second.weight >= weight) continue;
+                auto first = outPos.find(edgeKey(u, second.other));
+                if (first != outPos.end() && out[u][first->second].weight + second.weight <= weight) return true;
+            }
+        }
+        return false;
+    }
+
+    // Fills shortcuts with the edges contracting v would add. Direct and
+    // two-hop witnesses are found by hash probes; only targets left over
+    // need a witness search.
+    void findShortcuts(int v) {
+        shortcuts.clear();
+        for (size_t i = 0; i < in[v].size(); i++) {
+            ChEdge incoming = in[v][i];
+            int u = incoming.other;
+
+            int limit = -1, pending = 0;
+            for (const ChEdge& outgoing : out[v]) {
+                int x = outgoing.other;
+                if (x == u) continue;
+                int weight = incoming.weight + outgoing.weight;
+                auto direct = outPos.find(edgeKey(u, x));
+                if (direct != outPos.end() && out[u][direct->second].weight <= weight) continue;
+                if (twoHopWitness(u, x, v, weight)) continue;
+                need[x] = weight;
+                pending++;
+                limit = std::max(limit, weight);
+            }
+            if (pending == 0) continue;
+            
+            witnessSearch(u, v, limit, pending);
+            for (const ChEdge& outgoing : out[v]) {
+                int x = outgoing.other;
+                if (x == u || need[x] == -1) continue;
+                need[x] = -1;
+                int weight = incoming.weight + outgoing.weight;
+                if (witnessDist[x] <= weight) continue;
+                shortcuts.push_back(Shortcut{u, x, weight});
+            }
+            for (int t : touched) witnessDist[t] = INT_MAX;
+            touched.clear();
+        }
+    }
+};
+
+// FNV-1a over the CSR arrays, so an index can tell which graph it was built for
+uint64_t csrChecksum(const Graph& graph) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const std::vector<int>& values) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values.data());
+        for (size_t i = 0; i < values.size() * sizeof(int); i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    mix(graph.rowOffsets);
+    mix(graph.columnIndices);
+    mix(graph.edgeWeights);
+    return hash;
+}
+
+}  // namespace
+
+ContractionHierarchy::ContractionHierarchy() : graphEdges(0), graphChecksum(0) {}
+
+ContractionHierarchy::ContractionHierarchy(const Graph& graph)
+    : graphEdges(graph.numEdges()), graphChecksum(csrChecksum(graph)) {
+    std::vector<std::vector<ChEdge>> up, down;
+    ChBuilder(graph).contractAll(rank, up, down);
+    int n = graph.numVertices;
+    
+    // Pack both directions into CSR rows sorted by the other endpoint
+    auto pack = [n](std::vector<std::vector<ChEdge>>& rows, std::vector<int>& offsets, std::vector<int>& ends,
+                    std::vector<int>& weights, std::vector<int>& middles) {
+        offsets.assign(1, 0);
+        for (int v = 0; v < n; v++) {
+            std::sort(rows[v].begin(), rows[v].end(), [](const ChEdge& a, const ChEdge& b) {
+                return a.other < b.other;
+            });
+            for (const ChEdge& e : rows[v]) {
+                ends.push_back(e.other);
+                weights.push_back(e.weight);
+                middles.push_back(e.middle);
+            }
+            offsets.push_back(ends.size());
+        }
+    };
+    pack(up, upOffsets, upTargets, upWeights, upMiddles);
+    pack(down, downOffsets, downSources, downWeights, downMiddles);
+}
+
+bool ContractionHierarchy::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        perror("Failed to open file");
+        return false;
+    }
+    auto write_array = [&file](const std::vector<int>& values) {
+        uint64_t count = values.size();
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(values.data()), count * sizeof(int));
+    };
+    file.write("WGCH0002", 8);
+    uint64_t header[3] = {rank.size(), static_cast<uint64_t>(graphEdges), graphChecksum};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    write_array(rank);
+    write_array(upOffsets);
+    write_array(upTargets);
+    write_array(upWeights);
+    write_array(upMiddles);
+    write_array(downOffsets);
+    write_array(downSources);
+    write_array(downWeights);
+    write_array(downMiddles);
+    return static_cast<bool>(file);
+}
+
+bool ContractionHierarchy::load(const std::string& filename, const Graph& graph) {
+    // Drop any previous hierarchy so every rejection leaves this one empty
+    *this = ContractionHierarchy();
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        perror("Failed to open file");
+        return false;
+    }
+    uint64_t remaining = file.tellg();
+    file.seekg(0);
+    char magic[8];
+    if (remaining < 8 || !file.read(magic, 8) || std::string(magic, 8) != "WGCH0002") {
+        std::cerr << "Not a contraction hierarchy file: " << filename << std::endl;
+        return false;
+    }
+    remaining -= 8;
+    
+    uint64_t header[3];
+    if (remaining < sizeof(header) || !file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        std::cerr << "Corrupt contraction hierarchy file: " << filename << std::endl;
+        return false;
+    }
+    remaining -= sizeof(header);
+    if (header[0] != static_cast<uint64_t>(graph.numVertices) || header[1] != static_cast<uint64_t>(graph.numEdges()) ||
+        header[2] != csrChecksum(graph)) {
+        std::cerr << "Contraction hierarchy file was built for a different graph: " << filename << std::endl;
+        return false;
+    }
+    
+    // Array lengths are checked against the bytes left before allocating
+    auto read_array = [&](std::vector<int>& values) {
+        uint64_t count = 0;
+        if (remaining < sizeof(count) || !file.read(reinterpret_cast<char*>(&count), sizeof(count))) return false;
+        remaining -= sizeof(count);
+        if (count > remaining / sizeof(int)) return false;
+        remaining -= count * sizeof(int);
+        values.resize(count);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(values.data()), count * sizeof(int)));
+    };
+    graphEdges = header[1];
+    graphChecksum = header[2];
+    bool ok = read_array(rank) && read_array(upOffsets) && read_array(upTargets) &&
+              read_array(upWeights) && read_array(upMiddles) && read_array(downOffsets) &&
+              read_array(downSources) && read_array(downWeights) && read_array(downMiddles);
+    if (!ok || remaining != 0 || rank.size() != header[0] || !consistent()) {
+        std::cerr << "Corrupt contraction hierarchy file: " << filename << std::endl;
+        *this = ContractionHierarchy();
+        return false;
+    }
+    return true;
+}
+
+bool ContractionHierarchy::consistent() const {
+    int n = rank.size();
+    std::vector<bool> used(n, false);
+    for (int r : rank) {
+        if (r < 0 || r >= n || used[r]) return false;
+        used[r] = true;
+    }
+    // Each direction must be a CSR with rows sorted by in-range endpoints
+    auto valid_csr = [n](const std::vector<int>& offsets, const std::vector<int>& ends, const std::vector<int>& weights,
+                         const std::vector<int>& middles) {
+        if (offsets.size() != static_cast<size_t>(n) + 1 || offsets[0] != 0 ||
+            offsets[n] != static_cast<int>(ends.size()) || weights.size() != ends.size() ||
+            middles.size() != ends.size()) {
+            return false;
+        }
+        for (int v = 0; v < n; v++) {
+            if (offsets[v] > offsets[v + 1]) return false;
+            for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+                if (ends[e] < 0 || ends[e] >= n || (e > offsets[v] && ends[e] <= ends[e - 1])) return false;
+                if (weights[e] < 0 || middles[e] < -1 || middles[e] >= n) return false;
+            }
+        }
+        return true;
+    };
+    if (!valid_csr(upOffsets, upTargets, upWeights, upMiddles) ||
+        !valid_csr(downOffsets, downSources, downWeights, downMiddles)) {
+        return false;
+    }
+    // Up edges climb in rank, down edges descend, and every shortcut skips a
+    // lower-ranked middle through two edges that exist, so unpacking ends
+    for (int v = 0; v < n; v++) {
+        for (int e = upOffsets[v]; e < upOffsets[v + 1]; e++) {
+            int to = upTargets[e], middle = upMiddles[e];
+            if (rank[to] <= rank[v]) return false;
+            if (middle != -1 && (rank[middle] >= rank[v] || findEdge(v, middle) == -1 || findEdge(middle, to) == -1)) {
+                return false;
+            }
+        }
+        for (int e = downOffsets[v]; e < downOffsets[v + 1]; e++) {
+            int from = downSources[e], middle = downMiddles[e];
+            if (rank[from] <= rank[v]) return false;
+            if (middle != -1 && (rank[middle] >= rank[v] || findEdge(from, middle) == -1 || findEdge(middle, v) == -1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int ContractionHierarchy::numVertices() const { return rank.size(); }
+
+int ContractionHierarchy::numShortcuts() const {
+    int shortcuts = 0;
+    for (int middle : upMiddles) shortcuts += middle != -1;
+    for (int middle : downMiddles) shortcuts += middle != -1;
+    return shortcuts;
+}
+
+int ContractionHierarchy::findEdge(int from, int to) const {
+    // The lower-ranked endpoint owns the edge in the up or down structure
+    if (rank[from] < rank[to]) {
+        auto first = upTargets.begin() + upOffsets[from];
+        auto last = upTargets.begin() + upOffsets[from + 1];
+        auto it = std::lower_bound(first, last, to);
+        return it != last && *it == to ? it - upTargets.begin() : -1;
+    }
+    auto first = downSources.begin() + downOffsets[to];
+    auto last = downSources.begin() + downOffsets[to + 1];
+    auto it = std::lower_bound(first, last, from);
+    return it != last && *it == from ? it - downSources.begin() : -1;
+}
+
+int ContractionHierarchy::findMiddle(int from, int to) const {
+    int e = findEdge(from, to);
+    return rank[from] < rank[to] ? upMiddles[e] : downMiddles[e];
+}
+
+void ContractionHierarchy::unpackEdge(int from, int to, int middle, std::vector<int>& path) const {
+    if (middle == -1) {
+        path.push_back(to);
+        return;
+    }
+    unpackEdge(from, middle, findMiddle(from, middle), path);
+    unpackEdge(middle, to, findMiddle(middle, to), path);
+}
+
+int ContractionHierarchy::query(int source, int target, std::vector<int>& path) const {
+    thread_local QueryContext context;
+    return query(source, target, path, context);
+}
+
+int ContractionHierarchy::query(int source, int target, std::vector<int>& path, QueryContext& context) const {
+    path.clear();
+    int n = rank.size();
+    if (source < 0 || source >= n || target < 0 || target >= n) return INT_MAX;
+    // Parents are the packed edge indices that reached each vertex
+    SearchWorkspace* sides[2] = {&context.forward, &context.backward};
+    sides[0]->reset(rank.size());
+    sides[1]->reset(rank.size());
+    sides[0]->label(source, 0, -1);
+    sides[1]->label(target, 0, -1);
+    sides[0]->push(0, source);
+    sides[1]->push(0, target);
+    int best = INT_MAX;
+    int meeting = -1;
+    
+    // Both searches only climb in rank; each stops once it cannot improve
+    for (int side = 0; !sides[0]->empty() || !sides[1]->empty(); side ^= 1) {
+        SearchWorkspace& search = *sides[side];
+        const SearchWorkspace& other = *sides[side ^ 1];
+        if (search.empty()) continue;
+        std::pair<int, int> top = search.top();
+        search.pop();
+        int u = top.second;
+        if (top.first != search.distance(u)) continue;
+        if (top.first >= best) {
+            search.clearHeap();
+            continue;
+        }
+        if (other.distance(u) != INT_MAX && top.first + other.distance(u) < best) {
+            best = top.first + other.distance(u);
+            meeting = u;
+        }
+        const std::vector<int>& offsets = side == 0 ? upOffsets : downOffsets;
+        const std::vector<int>& ends = side == 0 ? upTargets : downSources;
+        const std::vector<int>& weights = side == 0 ? upWeights : downWeights;
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            int v = ends[e];
+            int candidate = top.first + weights[e];
+            if (candidate < search.distance(v)) {
+                search.label(v, candidate, e);
+                search.push(candidate, v);
+            }
+        }
+    }
+    if (meeting == -1) return INT_MAX;
+    
+    // Collect the packed edges source -> meeting and meeting -> target
+    std::vector<int> up_edges;
+    for (int v = meeting; v != source; ) {
+        int e = context.forward.parent(v);
+        up_edges.push_back(e);
+        v = std::upper_bound(upOffsets.begin(), upOffsets.end(), e) - upOffsets.begin() - 1;
+    }
+    path.push_back(source);
+    for (auto it = up_edges.rbegin(); it != up_edges.rend(); ++it) {
+        int from = std::upper_bound(upOffsets.begin(), upOffsets.end(), *it) - upOffsets.begin() - 1;
+        unpackEdge(from, upTargets[*it], upMiddles[*it], path);
+    }
+    for (int v = meeting; v != target; ) {
+        int e = context.backward.parent(v);
+        int to = std::upper_bound(downOffsets.begin(), downOffsets.end(), e) - downOffsets.begin() - 1;
+        unpackEdge(v, to, downMiddles[e], path);
+        v = to;
+    }
+    return best;
+}
+
+DistanceMatrix::DistanceMatrix(const Graph& graph, Method method, int num_threads)
+    : graph(graph), n(graph.numVertices), dist(static_cast<size_t>(graph.numVertices) * graph.numVertices) {
+    if (num_threads <= 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (method == Method::Auto) {
+        // Floyd-Warshall pays off once E log V approaches V^2
+        double log_n = std::log2(std::max(2, n));
+        method = graph.numEdges() * log_n >= static_cast<double>(n) * n ? Method::BlockedFloydWarshall
+                                                                         : Method::PerSourceDijkstra;
+    }
+    if (method == Method::PerSourceDijkstra) {
+        fillByDijkstra(num_threads);
+    } else {
+        fillByFloydWarshall(num_threads);
+    }
+}
+
+int DistanceMatrix::numVertices() const { return n; }
+
+const uint16_t* DistanceMatrix::row(int from) const { return dist.data() + static_cast<size_t>(from) * n; }
+
+int DistanceMatrix::distance(int from, int to) const {
+    uint16_t d = row(from)[to];
+    return d == UNREACHABLE ? INT_MAX : d;
+}
+
+bool DistanceMatrix::shortestPath(int from, int to, std::vector<int>& path) const {
+    path.clear();
+    int remaining = distance(from, to);
+    if (remaining == INT_MAX || remaining == SATURATED) return false;
+    
+    // Next hop: the first neighbour that still lies on a shortest path
+    path.push_back(from);
+    for (int u = from; u != to; ) {
+        int next = -1;
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            int v = graph.columnIndices[e];
+            if (distance(v, to) != INT_MAX && graph.edgeWeights[e] + distance(v, to) == remaining) {
+                next = v;
+                remaining -= graph.edgeWeights[e];
+                break;
+            }
+        }
+        if (next == -1) return false;
+        path.push_back(next);
+        u = next;
+    }
+    return true;
+}
+
+void DistanceMatrix::fillByDijkstra(int num_threads) {
+    std::atomic<int> next_source(0);
+    auto work = [&]() {
+        SearchWorkspace workspace;
+        for (int s = next_source++; s < n; s = next_source++) {
+            dijkstraOver(graph.rowOffsets, graph.columnIndices, graph.edgeWeights, s, workspace, -1);
+            uint16_t* out = dist.data() + static_cast<size_t>(s) * n;
+            for (int t = 0; t < n; t++) {
+                int d = workspace.distance(t);
+                out[t] = d == INT_MAX ? UNREACHABLE : static_cast<uint16_t>(std::min<int>(d, SATURATED));
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < num_threads; t++) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void DistanceMatrix::relaxBlock(int ib, int jb, int kb) {
+    int i_end = std::min(n, (ib + 1) * BLOCK);
+    int j_begin = jb * BLOCK, j_end = std::min(n, (jb + 1) * BLOCK);
+    int k_end = std::min(n, (kb + 1) * BLOCK);
+    // k outermost keeps in-place updates valid when blocks overlap
+    uint16_t via[BLOCK];
+    for (int k = kb * BLOCK; k < k_end; k++) {
+        // A local copy of row k cannot alias the rows being updated
+        std::copy(dist.begin() + static_cast<size_t>(k) * n + j_begin,
+                  dist.begin() + static_cast<size_t>(k) * n + j_end, via);
+        for (int i = ib * BLOCK; i < i_end; i++) {
+            uint16_t to_k = dist[static_cast<size_t>(i) * n + k];
+            if (to_k == UNREACHABLE) continue;
+            minPlusRow(dist.data() + static_cast<size_t>(i) * n + j_begin, via, to_k, j_end - j_begin);
+        }
+    }
+}
+
+void DistanceMatrix::fillByFloydWarshall(int num_threads) {
+    std::fill(dist.begin(), dist.end(), UNREACHABLE);
+    for (int u = 0; u < n; u++) {
+        uint16_t* out = dist.data() + static_cast<size_t>(u) * n;
+        out[u] = 0;
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            int v = graph.columnIndices[e];
+            out[v] = std::min<int>(out[v], std::min<int>(graph.edgeWeights[e], SATURATED));
+        }
+    }
+    
+    int blocks = (n + BLOCK - 1) / BLOCK;
+    num_threads = std::max(1, std::min(num_threads, blocks));
+    // Runs body(b) for every block index except skip, spread over threads
+    auto parallelBlocks = [&](int skip, const std::function<void(int)>& body) {
+        auto work = [&](int t) {
+            for (int b = t; b < blocks; b += num_threads) {
+                if (b != skip) body(b);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int t = 1; t < num_threads; t++) {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    };
+    
+    for (int kb = 0; kb < blocks; kb++) {
+        // Pivot block, then its row and column, then everything else
+        relaxBlock(kb, kb, kb);
+        parallelBlocks(kb, [&](int b) {
+            relaxBlock(kb, b, kb);
+            relaxBlock(b, kb, kb);
+        });
+        parallelBlocks(kb, [&](int ib) {
+            for (int jb = 0; jb < blocks; jb++) {
+                if (jb != kb) relaxBlock(ib, jb, kb);
+            }
+        });
+    }
+}
+
+ShortestPathDag::ShortestPathDag(const Graph& graph, int source, int target, const std::vector<int>& dist)
+    : graph(graph), dist(&dist), context(nullptr), settledLabels(nullptr), source(source), target(target),
+      targetDistance(dist[target]), pathsToTarget(ownCounts), started(false) {
+    countPaths();
+}
+
+ShortestPathDag::ShortestPathDag(const Graph& graph, int source, int target, int distance, QueryContext& context)
+    : graph(graph), dist(nullptr), context(&context), settledLabels(nullptr), source(source), target(target),
+      targetDistance(distance), pathsToTarget(context.paths), started(false) {
+    countPaths();
+}
+
+ShortestPathDag::ShortestPathDag(const Graph& graph, int source, int target, int distance,
+                                 const SearchWorkspace& workspace, PathCounts& counts)
+    : graph(graph), dist(nullptr), context(nullptr), settledLabels(&workspace), source(source), target(target),
+      targetDistance(distance), pathsToTarget(counts), started(false) {
+    countPaths();
+}
+
+int ShortestPathDag::label(int v) const {
+    if (dist) return (*dist)[v];
+    if (v == target) return targetDistance;
+    if (v == source) return 0;
+    if (settledLabels) return settledLabels->settled(v) ? settledLabels->distance(v) : INT_MAX;
+    
+    // Same labels bidirectionalDijkstra copies out densely
+    if (context->forward.settled(v)) return context->forward.distance(v);
+    if (context->backward.settled(v) && context->backward.distance(v) <= targetDistance) {
+        return targetDistance - context->backward.distance(v);
+    }
+    return INT_MAX;
+}
+
+void ShortestPathDag::countPaths() {
+    pathsToTarget.reset(graph.numVertices);
+    if (targetDistance == INT_MAX) return;
+    pathsToTarget.set(target, 1);
+    if (source == target) return;
+    
+    // Post-order walk over tight edges; a vertex's count is final when popped
+    std::vector<std::pair<int, int>> stack;
+    pathsToTarget.set(source, 0);
+    stack.push_back(std::make_pair(source, graph.rowOffsets[source]));
+    while (!stack.empty()) {
+        int u = stack.back().first;
+        int& e = stack.back().second;
+        if (e == graph.rowOffsets[u + 1]) {
+            stack.pop_back();
+            continue;
+        }
+        if (!onDag(u, e)) {
+            e++;
+            continue;
+        }
+        int v = graph.columnIndices[e];
+        if (!pathsToTarget.seen(v)) {
+            pathsToTarget.set(v, 0);
+            stack.push_back(std::make_pair(v, graph.rowOffsets[v]));
+            continue;
+        }
+        uint64_t sum = pathsToTarget.count(u) + pathsToTarget.count(v);
+        pathsToTarget.set(u, sum < pathsToTarget.count(u) ? UINT64_MAX : sum);
+        e++;
+    }
+}
+
+bool ShortestPathDag::onDag(int from, int edge) const {
+    int to = graph.columnIndices[edge];
+    if (to == target) return label(from) + graph.edgeWeights[edge] == targetDistance;
+    int to_label = label(to);
+    return to_label < targetDistance && label(from) + graph.edgeWeights[edge] == to_label;
+}
+
+int ShortestPathDag::distance() const { return targetDistance; }
+
+uint64_t ShortestPathDag::pathCount() const { return pathsToTarget.count(source); }
+
+bool ShortestPathDag::nextPath(std::vector<int>& path) {
+    if (pathsToTarget.count(source) == 0) return false;
+    
+    // Resume from the last path by advancing its deepest edge
+    int u;
+    if (!started) {
+        started = true;
+        u = source;
+    } else {
+        for (;;) {
+            if (pathEdges.empty()) return false;
+            int e = pathEdges.back() + 1;
+            pathEdges.pop_back();
+            u = pathEdges.empty() ? source : graph.columnIndices[pathEdges.back()];
+            for (; e < graph.rowOffsets[u + 1]; e++) {
+                if (onDag(u, e) && pathsToTarget.count(graph.columnIndices[e]) > 0) break;
+            }
+            if (e < graph.rowOffsets[u + 1]) {
+                pathEdges.push_back(e);
+                u = graph.columnIndices[e];
+                break;
+            }
+        }
+    }
+    
+    // Descend along the first edge that still leads to the target
+    while (u != target) {
+        int e = graph.rowOffsets[u];
+        while (!(onDag(u, e) && pathsToTarget.count(graph.columnIndices[e]) > 0)) {
+            e++;
+        }
+        pathEdges.push_back(e);
+        u = graph.columnIndices[e];
+    }
+    
+    path.assign(1, source);
+    for (int e : pathEdges) {
+        path.push_back(graph.columnIndices[e]);
+    }
+    return true;
+}
+
+PathList findAllShortestPaths(const Graph& graph, int id1, int id2, const std::vector<int>& dist) {
+    ShortestPathDag dag(graph, id1, id2, dist);
+    return findAllShortestPaths(dag);
+}
+
+PathList findAllShortestPaths(ShortestPathDag& dag) {
+    PathList path_list;
+    path_list.total_paths = dag.pathCount();
+    
+    // Paths are written in place rather than copied in
+    while (path_list.paths.size() < MAX_PATHS) {
+        path_list.paths.emplace_back();
+        if (!dag.nextPath(path_list.paths.back())) {
+            path_list.paths.pop_back();
+            break;
+        }
+        path_list.path_lengths.push_back(path_list.paths.back().size());
+        path_list.path_weights.push_back(dag.distance());
+    }
+    return path_list;
+}
+
+namespace {
+
+// Dijkstra workspace reused across Yen's spur searches. Banned vertices and
+// edges are flagged in place and cleared through their touched lists.
+class SpurSearch {
+public:
+    explicit SpurSearch(const Graph& graph)
+        : graph(graph), bannedVertex(graph.numVertices, 0), bannedEdge(graph.numEdges(), 0) {}
+
+    void banVertex(int v) {
+        bannedVertex[v] = 1;
+        bannedVertices.push_back(v);
+    }
+
+    void banEdge(int from, int to) {
+        int e = graph.edgeIndex(from, to);
+        if (e == -1 || bannedEdge[e]) return;
+        bannedEdge[e] = 1;
+        bannedEdges.push_back(e);
+    }
+
+    void clearBans() {
+        for (int v : bannedVertices) bannedVertex[v] = 0;
+        for (int e : bannedEdges) bannedEdge[e] = 0;
+        bannedVertices.clear();
+        bannedEdges.clear();
+    }
+
+    // Shortest path avoiding the bans; returns its weight or INT_MAX
+    int run(int source, int target, std::vector<int>& path) {
+        workspace.reset(graph.numVertices);
+        workspace.label(source, 0, -1);
+        workspace.push(0, source);
+        while (!workspace.empty()) {
+            std::pair<int, int> top = workspace.top();
+            workspace.pop();
+            int u = top.second;
+            if (top.first != workspace.distance(u)) continue;
+            if (u == target) break;
+            for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+                int v = graph.columnIndices[e];
+                if (bannedEdge[e] || bannedVertex[v]) continue;
+                int candidate = top.first + graph.edgeWeights[e];
+                if (candidate < workspace.distance(v)) {
+                    workspace.label(v, candidate, u);
+                    workspace.push(candidate, v);
+                }
+            }
+        }
+        
+        path.clear();
+        if (workspace.distance(target) == INT_MAX) return INT_MAX;
+        for (int at = target; at != -1; at = workspace.parent(at)) {
+            path.push_back(at);
+        }
+        std::reverse(path.begin(), path.end());
+        return workspace.distance(target);
+    }
+
+private:
+    const Graph& graph;
+    SearchWorkspace workspace;
+    std::vector<char> bannedVertex;
+    std::vector<char> bannedEdge;
+    std::vector<int> bannedVertices;
+    std::vector<int> bannedEdges;
+};
+
+}  // namespace
+
+PathList kShortestPaths(const Graph& graph, int source, int target, int k) {
+    PathList result;
+    if (k <= 0) return result;
+    SpurSearch search(graph);
+    std::vector<int> path;
+    int weight = search.run(source, target, path);
+    if (weight == INT_MAX) return result;
+    
+    // Candidates ordered by weight, then by word ids for a stable order
+    typedef std::pair<int, std::vector<int>> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    std::set<std::vector<int>> seen;
+    seen.insert(path);
+    result.paths.push_back(path);
+    result.path_weights.push_back(weight);
+    
+    std::vector<int> spur_path;
+    while (static_cast<int>(result.paths.size()) < k) {
+        const std::vector<int> last = result.paths.back();
+        int root_weight = 0;
+        for (size_t i = 0; i + 1 < last.size(); i++) {
+            int spur = last[i];
+            // Deviate at spur: no edge already taken after this root, and
+            // no revisiting the root, so every candidate stays simple
+            for (const std::vector<int>& accepted : result.paths) {
+                if (accepted.size() > i + 1 && std::equal(last.begin(), last.begin() + i + 1, accepted.begin())) {
+                    search.banEdge(accepted[i], accepted[i + 1]);
+                }
+            }
+            for (size_t j = 0; j < i; j++) {
+                search.banVertex(last[j]);
+            }
+            
+            int spur_weight = search.run(spur, target, spur_path);
+            search.clearBans();
+            if (spur_weight != INT_MAX) {
+                std::vector<int> candidate(last.begin(), last.begin() + i);
+                candidate.insert(candidate.end(), spur_path.begin(), spur_path.end());
+                if (seen.insert(candidate).second) {
+                    candidates.push(Candidate(root_weight + spur_weight, candidate));
+                }
+            }
+            root_weight += graph.edgeWeight(last[i], last[i + 1]);
+        }
+        
+        if (candidates.empty()) break;
+        result.paths.push_back(candidates.top().second);
+        result.path_weights.push_back(candidates.top().first);
+        candidates.pop();
+    }
+    
+    for (const std::vector<int>& accepted : result.paths) {
+        result.path_lengths.push_back(accepted.size());
+    }
+    result.total_paths = result.paths.size();
+    return result;
+}
+
+namespace {
+
+void writeShortestPathDot(const Graph& graph, const WordTable& table, int id1, int id2,
+                          const PathList& path_list) {
+    std::ofstream file("shortest_path.dot");
+    if (!file.is_open()) {
+        perror("Failed to open file");
+        return;
+    }
+    
+    file << "digraph G {\n";
+    file << "  rankdir=LR;\n";
+    file << "  node [shape=circle];\n";
+    
+    const std::vector<std::string> path_colors = {
+        "red", "blue", "green", "purple", "orange",
+        "brown", "pink", "cyan", "magenta", "gold"
+    };
+    
+    // Colour each edge by the first path that uses it
+    std::vector<int> edge_path(graph.numEdges(), -1);
+    for (size_t k = 0; k < path_list.paths.size(); k++) {
+        for (size_t l = 0; l + 1 < path_list.paths[k].size(); l++) {
+            int e = graph.edgeIndex(path_list.paths[k][l], path_list.paths[k][l+1]);
+            if (e != -1 && edge_path[e] == -1) {
+                edge_path[e] = k;
+            }
+        }
+    }
+    
+    for (int i = 0; i < graph.numVertices; i++) {
+        for (int e = graph.rowOffsets[i]; e < graph.rowOffsets[i + 1]; e++) {
+            int j = graph.columnIndices[e];
+            int weight = graph.edgeWeights[e];
+            if (edge_path[e] != -1) {
+                file << "  \"" << table.word(i) << "\" -> \"" << table.word(j)
+                     << "\" [label=\"" << weight << "\", color=" << path_colors[edge_path[e] % path_colors.size()] 
+                     << ", penwidth=2.0, style=bold];\n";
+            } else {
+                file << "  \"" << table.word(i) << "\" -> \"" << table.word(j)
+                     << "\" [label=\"" << weight << "\"];\n";
+            }
+        }
+    }
+    
+    file << "  \"" << table.word(id1) << "\" [color=green, penwidth=2.0];\n";
+    file << "  \"" << table.word(id2) << "\" [color=blue, penwidth=2.0];\n";
+    
+    file << "}\n";
+    
+    std::cout << "Shortest path visualization generated with " << path_list.paths.size() 
+         << " paths. Run: dot -Tpng shortest_path.dot -o shortest_path.png" << std::endl;
+}
+
+void reportShortestPaths(const Graph& graph, const WordTable& table, const std::string& word1,
+                         const std::string& word2, int id1, int id2, ShortestPathDag& dag) {
+    if (dag.distance() == INT_MAX) {
+        std::cout << "No path from " << word1 << " to " << word2 << "!" << std::endl;
+        return;
     }
     
-    while (original_pos < input_text.size()) {
-        new_text += input_text[original_pos++];
-    }
+    PathList path_list = findAllShortestPaths(dag);
     
-    std::cout << "Generated new text: " << new_text << std::endl;
+    if (path_list.paths.empty()) {
+        std::cout << "No path found (should not happen)" << std::endl;
+        return;
+    }
     
-    while (input_list) {
-        WordNode* next_node = input_list->next;
-        delete input_list;
-        input_list = next_node;
+    std::cout << "Found " << path_list.total_paths << " shortest path(s) from " 
+         << word1 << " to " << word2 << " (length " << dag.distance() << ")";
+    if (path_list.total_paths > path_list.paths.size()) {
+        std::cout << ", showing the first " << path_list.paths.size();
     }
-}
-
-void backtrackPaths(const Graph& graph, int u, int v, const std::vector<int>& dist, 
-                   std::vector<int>& path, PathList& path_list) {
-    path.push_back(u);
+    std::cout << ":" << std::endl;
     
-    if (u == v) {
-        if (path_list.paths.size() < MAX_PATHS) {
-            path_list.paths.push_back(path);
-            path_list.path_lengths.push_back(path.size());
-        }
-    } else {
-        for (int i = 0; i < graph.numVertices; i++) {
-            if (graph.adjacencyMatrix[u][i] > 0 && dist[i] == dist[u] + graph.adjacencyMatrix[u][i]) {
-                backtrackPaths(graph, i, v, dist, path, path_list);
+    for (size_t i = 0; i < path_list.paths.size(); i++) {
+        std::cout << "Path " << i+1 << ": ";
+        for (size_t j = 0; j < path_list.paths[i].size(); j++) {
+            std::cout << table.word(path_list.paths[i][j]);
+            if (j < path_list.paths[i].size() - 1) {
+                std::cout << " -> ";
             }
         }
+        std::cout << std::endl;
     }
     
-    path.pop_back();
+    writeShortestPathDot(graph, table, id1, id2, path_list);
 }
 
-PathList findAllShortestPaths(const Graph& graph, int id1, int id2, const std::vector<int>& dist) {
-    PathList path_list;
-    std::vector<int> path;
-    
-    backtrackPaths(graph, id1, id2, dist, path, path_list);
-    return path_list;
+void reportShortestPaths(const Graph& graph, const WordTable& table, const std::string& word1,
+                         const std::string& word2, int id1, int id2, const std::vector<int>& dist) {
+    ShortestPathDag dag(graph, id1, id2, dist);
+    reportShortestPaths(graph, table, word1, word2, id1, id2, dag);
+}
+
+void printShortestPath(const WordTable& table, const std::string& word1, int target, int length,
+                       const std::vector<int>& path) {
+    std::cout << "Shortest path from " << word1 << " to " << table.word(target) 
+         << " (length " << length << "):" << std::endl;
+    for (size_t j = 0; j < path.size(); j++) {
+        std::cout << table.word(path[j]);
+        if (j < path.size() - 1) {
+            std::cout << " -> ";
+        }
+    }
+    std::cout << std::endl;
 }
 
+}  // namespace
+
 void showShortestPath(const Graph& graph, const WordTable& table, 
-                     const std::string& word1, const std::string& word2) {
+                     const std::string& word1, const std::string& word2, ThreadPool* pool) {
     int id1 = table.getIndex(word1);
     if (id1 == -1) {
         std::cout << "No " << word1 << " in the graph!" << std::endl;
@@ -391,58 +2687,31 @@ void showShortestPath(const Graph& graph, const WordTable& table,
     if (word2.empty()) {
         std::cout << "Calculating shortest paths from '" << word1 << "' to all other words:" << std::endl;
         
-        std::vector<int> dist(graph.numVertices, INT_MAX);
-        std::vector<int> prev(graph.numVertices, -1);
-        std::vector<bool> visited(graph.numVertices, false);
-        
-        dist[id1] = 0;
-        
-        for (int count = 0; count < graph.numVertices - 1; count++) {
-            int min_dist = INT_MAX;
-            int u = -1;
-            
-            for (int v = 0; v < graph.numVertices; v++) {
-                if (!visited[v] && dist[v] < min_dist) {
-                    min_dist = dist[v];
-                    u = v;
-                }
-            }
-            
-            if (u == -1) break;
-            visited[u] = true;
-            
-            for (int v = 0; v < graph.numVertices; v++) {
-                if (!visited[v] && graph.adjacencyMatrix[u][v] > 0 && 
-                    dist[u] != INT_MAX && dist[u] + graph.adjacencyMatrix[u][v] < dist[v]) {
-                    dist[v] = dist[u] + graph.adjacencyMatrix[u][v];
-                    prev[v] = u;
-                }
-            }
+        // Buffers are kept per thread so repeated queries do not reallocate
+        thread_local std::vector<int> dist;
+        thread_local std::vector<int> prev;
+        thread_local std::vector<int> path;
+        if (pool) {
+            thread_local DeltaSteppingWorkspace workspace;
+            deltaStepping(graph, id1, dist, prev, *pool, workspace);
+        } else {
+            dijkstra(graph, id1, dist, prev);
         }
         
         for (int i = 0; i < graph.numVertices; i++) {
             if (i == id1) continue;
             
             if (dist[i] == INT_MAX) {
-                std::cout << "No path from " << word1 << " to " << table.words[i] << "!" << std::endl;
+                std::cout << "No path from " << word1 << " to " << table.word(i) << "!" << std::endl;
                 continue;
             }
             
-            std::vector<int> path;
+            path.clear();
             for (int at = i; at != -1; at = prev[at]) {
                 path.push_back(at);
             }
             std::reverse(path.begin(), path.end());
-            
-            std::cout << "Shortest path from " << word1 << " to " << table.words[i] 
-                 << " (length " << dist[i] << "):" << std::endl;
-            for (size_t j = 0; j < path.size(); j++) {
-                std::cout << table.words[path[j]];
-                if (j < path.size() - 1) {
-                    std::cout << " -> ";
-                }
-            }
-            std::cout << std::endl;
+            printShortestPath(table, word1, i, dist[i], path);
         }
         return;
     }
@@ -453,179 +2722,666 @@ void showShortestPath(const Graph& graph, const WordTable& table,
         return;
     }
     
-    std::vector<int> dist(graph.numVertices, INT_MAX);
-    std::vector<int> prev(graph.numVertices, -1);
-    std::vector<bool> visited(graph.numVertices, false);
-    
-    dist[id1] = 0;
-    
-    for (int count = 0; count < graph.numVertices - 1; count++) {
-        int min_dist = INT_MAX;
-        int u = -1;
-        
-        for (int v = 0; v < graph.numVertices; v++) {
-            if (!visited[v] && dist[v] < min_dist) {
-                min_dist = dist[v];
-                u = v;
-            }
-        }
-        
-        if (u == -1) break;
-        visited[u] = true;
-        
-        for (int v = 0; v < graph.numVertices; v++) {
-            if (!visited[v] && graph.adjacencyMatrix[u][v] > 0 && 
-                dist[u] != INT_MAX && dist[u] + graph.adjacencyMatrix[u][v] < dist[v]) {
-                dist[v] = dist[u] + graph.adjacencyMatrix[u][v];
-                prev[v] = u;
-            }
-        }
+    thread_local QueryContext context;
+    int distance = bidirectionalDijkstra(graph, id1, id2, context);
+    ShortestPathDag dag(graph, id1, id2, distance, context);
+    reportShortestPaths(graph, table, word1, word2, id1, id2, dag);
+}
+
+void showShortestPath(const Graph& graph, const WordTable& table, const LandmarkIndex& index,
+                      const std::string& word1, const std::string& word2) {
+    int id1 = table.getIndex(word1);
+    int id2 = table.getIndex(word2);
+    if (id1 == -1) {
+        std::cout << "No " << word1 << " in the graph!" << std::endl;
+        return;
     }
-    
-    if (dist[id2] == INT_MAX) {
-        std::cout << "No path from " << word1 << " to " << word2 << "!" << std::endl;
+    if (id2 == -1) {
+        std::cout << "No " << word2 << " in the graph!" << std::endl;
         return;
     }
     
-    PathList path_list = findAllShortestPaths(graph, id1, id2, dist);
+    // Only the corridor A* settled is visited; nothing V-sized is copied
+    thread_local QueryContext context;
+    int distance = index.query(id1, id2, context.forward);
+    ShortestPathDag dag(graph, id1, id2, distance, context.forward, context.paths);
+    reportShortestPaths(graph, table, word1, word2, id1, id2, dag);
+}
+
+void showShortestPath(const Graph& graph, const WordTable& table,
+                      const std::string& word1, const std::string& word2, int k) {
+    int id1 = table.getIndex(word1);
+    int id2 = table.getIndex(word2);
+    if (id1 == -1) {
+        std::cout << "No " << word1 << " in the graph!" << std::endl;
+        return;
+    }
+    if (id2 == -1) {
+        std::cout << "No " << word2 << " in the graph!" << std::endl;
+        return;
+    }
     
+    PathList path_list = kShortestPaths(graph, id1, id2, k);
     if (path_list.paths.empty()) {
-        std::cout << "No path found (should not happen)" << std::endl;
+        std::cout << "No path from " << word1 << " to " << word2 << "!" << std::endl;
         return;
     }
     
-    std::cout << "Found " << path_list.paths.size() << " shortest path(s) from " 
-         << word1 << " to " << word2 << " (length " << dist[id2] << "):" << std::endl;
-    
+    std::cout << "Found " << path_list.paths.size() << " shortest simple path(s) from "
+         << word1 << " to " << word2 << ":" << std::endl;
     for (size_t i = 0; i < path_list.paths.size(); i++) {
-        std::cout << "Path " << i+1 << ": ";
+        std::cout << "Path " << i+1 << " (length " << path_list.path_weights[i] << "): ";
         for (size_t j = 0; j < path_list.paths[i].size(); j++) {
-            std::cout << table.words[path_list.paths[i][j]];
+            std::cout << table.word(path_list.paths[i][j]);
             if (j < path_list.paths[i].size() - 1) {
                 std::cout << " -> ";
             }
         }
         std::cout << std::endl;
     }
+    writeShortestPathDot(graph, table, id1, id2, path_list);
+}
+
+void showShortestPath(const Graph& graph, const WordTable& table, const DistanceMatrix& matrix,
+                      const std::string& word1, const std::string& word2) {
+    int id1 = table.getIndex(word1);
+    if (id1 == -1) {
+        std::cout << "No " << word1 << " in the graph!" << std::endl;
+        return;
+    }
     
-    std::ofstream file("shortest_path.dot");
-    if (!file.is_open()) {
-        perror("Failed to open file");
+    if (word2.empty()) {
+        std::cout << "Calculating shortest paths from '" << word1 << "' to all other words:" << std::endl;
+        
+        // Clamped entries fall back to one exact Dijkstra, run on first need
+        std::vector<int> path;
+        std::vector<int> exact, prev;
+        for (int i = 0; i < matrix.numVertices(); i++) {
+            if (i == id1) continue;
+            
+            if (matrix.row(id1)[i] == DistanceMatrix::SATURATED) {
+                if (exact.empty()) dijkstra(graph, id1, exact, prev);
+                path.clear();
+                for (int at = i; at != -1; at = prev[at]) {
+                    path.push_back(at);
+                }
+                std::reverse(path.begin(), path.end());
+                printShortestPath(table, word1, i, exact[i], path);
+                continue;
+            }
+            if (!matrix.shortestPath(id1, i, path)) {
+                std::cout << "No path from " << word1 << " to " << table.word(i) << "!" << std::endl;
+                continue;
+            }
+            printShortestPath(table, word1, i, matrix.distance(id1, i), path);
+        }
         return;
     }
     
-    file << "digraph G {\n";
-    file << "  rankdir=LR;\n";
-    file << "  node [shape=circle];\n";
+    int id2 = table.getIndex(word2);
+    if (id2 == -1) {
+        std::cout << "No " << word2 << " in the graph!" << std::endl;
+        return;
+    }
     
-    const std::vector<std::string> path_colors = {
-        "red", "blue", "green", "purple", "orange",
-        "brown", "pink", "cyan", "magenta", "gold"
-    };
+    std::vector<int> dist;
+    if (matrix.row(id1)[id2] == DistanceMatrix::SATURATED) {
+        bidirectionalDijkstra(graph, id1, id2, dist);
+    } else {
+        // Clamped entries are longer than the target's distance, so they are
+        // off every shortest path and can read as unreached
+        dist.assign(matrix.row(id1), matrix.row(id1) + matrix.numVertices());
+        for (int& d : dist) {
+            if (d == DistanceMatrix::UNREACHABLE || d == DistanceMatrix::SATURATED) d = INT_MAX;
+        }
+    }
+    reportShortestPaths(graph, table, word1, word2, id1, id2, dist);
+}
+
+PageRankEngine::PageRankEngine(const Graph& graph, ThreadPool* pool)
+    : graph(graph), pool(pool), factors(graph.inSources.size()) {
+    std::vector<long long> out_weight(graph.numVertices, 0);
+    for (int u = 0; u < graph.numVertices; u++) {
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            out_weight[u] += graph.edgeWeights[e];
+        }
+        if (out_weight[u] == 0) {
+            dangling.push_back(u);
+        }
+    }
+    for (size_t e = 0; e < graph.inSources.size(); e++) {
+        factors[e] = static_cast<double>(graph.inWeights[e]) / out_weight[graph.inSources[e]];
+    }
+}
+
+int PageRankEngine::numVertices() const { return graph.numVertices; }
+
+const std::vector<int>& PageRankEngine::danglingVertices() const { return dangling; }
+
+double PageRankEngine::danglingMass(const std::vector<double>& rank) const {
+    double mass = 0.0;
+    for (int u : dangling) {
+        mass += rank[u];
+    }
+    return mass;
+}
+
+double PageRankEngine::step(const std::vector<double>& rank, std::vector<double>& next, double damping,
+                            const std::vector<double>* teleport) const {
+    return jacobiSweep(rank, next, damping, teleport, 0);
+}
+
+double PageRankEngine::jacobiSweep(const std::vector<double>& rank, std::vector<double>& next, double damping,
+                                   const std::vector<double>* teleport, int threads) const {
+    int n = graph.numVertices;
+    // Teleport weight per vertex, scaled by teleport[v] when personalized
+    double base = (1.0 - damping) + damping * danglingMass(rank);
+    double uniform = base / n;
     
-    for (int i = 0; i < graph.numVertices; i++) {
-        for (int j = 0; j < graph.numVertices; j++) {
-            int weight = graph.adjacencyMatrix[i][j];
-            if (weight != 0) {
-                bool is_path_edge = false;
-                size_t path_index = 0;
-                
-                for (size_t k = 0; k < path_list.paths.size(); k++) {
-                    for (size_t l = 0; l < path_list.paths[k].size() - 1; l++) {
-                        if (path_list.paths[k][l] == i && path_list.paths[k][l+1] == j) {
-                            is_path_edge = true;
-                            path_index = k;
-                            break;
-                        }
-                    }
-                    if (is_path_edge) break;
-                }
-                
-                if (is_path_edge) {
-                    file << "  \"" << table.words[i] << "\" -> \"" << table.words[j]
-                         << "\" [label=\"" << weight << "\", color=" << path_colors[path_index % path_colors.size()] 
-                         << ", penwidth=2.0, style=bold];\n";
-                } else {
-                    file << "  \"" << table.words[i] << "\" -> \"" << table.words[j]
-                         << "\" [label=\"" << weight << "\"];\n";
-                }
+    next.resize(n);
+    int blocks = (n + BLOCK - 1) / BLOCK;
+    std::vector<double> block_diff(blocks);
+    std::atomic<int> next_block(0);
+    auto work = [&](int thread) {
+        if (threads > 0 && thread >= threads) return;
+        for (int b = next_block++; b < blocks; b = next_block++) {
+            double diff = 0.0;
+            for (int v = b * BLOCK; v < std::min(n, (b + 1) * BLOCK); v++) {
+                int begin = graph.inOffsets[v];
+                double pulled = pullSum(factors.data() + begin, graph.inSources.data() + begin, rank.data(),
+                                        graph.inOffsets[v + 1] - begin);
+                next[v] = (teleport ? base * (*teleport)[v] : uniform) + damping * pulled;
+                diff += std::fabs(next[v] - rank[v]);
             }
+            block_diff[b] = diff;
         }
+    };
+    if (pool && pool->size() > 1 && threads != 1 && blocks > 1) {
+        pool->run(work);
+    } else {
+        work(0);
     }
     
-    file << "  \"" << table.words[id1] << "\" [color=green, penwidth=2.0];\n";
-    file << "  \"" << table.words[id2] << "\" [color=blue, penwidth=2.0];\n";
+    double diff = 0.0;
+    for (double d : block_diff) {
+        diff += d;
+    }
+    return diff;
+}
+
+double PageRankEngine::gaussSeidelSweep(std::vector<double>& rank, double damping,
+                                        const std::vector<double>* teleport) const {
+    // In place and serial: later vertices pull from values already updated
+    // this sweep. The dangling mass is taken from the start of the sweep.
+    int n = graph.numVertices;
+    double base = (1.0 - damping) + damping * danglingMass(rank);
+    double uniform = base / n;
+    double diff = 0.0;
+    for (int v = 0; v < n; v++) {
+        int begin = graph.inOffsets[v];
+        double pulled = pullSum(factors.data() + begin, graph.inSources.data() + begin, rank.data(),
+                                graph.inOffsets[v + 1] - begin);
+        double value = (teleport ? base * (*teleport)[v] : uniform) + damping * pulled;
+        diff += std::fabs(value - rank[v]);
+        rank[v] = value;
+    }
+    return diff;
+}
+
+int PageRankEngine::run(std::vector<double>& rank, double damping, int max_iterations, double tolerance,
+                        const std::vector<double>* teleport) const {
+    PageRankOptions options;
+    options.damping = damping;
+    options.max_iterations = max_iterations;
+    options.tolerance = tolerance;
+    return solve(rank, options, teleport).iterations;
+}
+
+namespace {
+
+void normalizeRank(std::vector<double>& rank) {
+    double sum = 0.0;
+    for (double& r : rank) {
+        r = std::max(r, 0.0);
+        sum += r;
+    }
+    if (sum <= 0.0) return;
+    for (double& r : rank) {
+        r /= sum;
+    }
+}
+
+// Componentwise Aitken delta-squared over three successive iterates,
+// applied only where a component is converging monotonically
+void aitkenExtrapolate(const std::vector<std::vector<double>>& history, std::vector<double>& rank) {
+    const std::vector<double>& x0 = history[0];
+    const std::vector<double>& x1 = history[1];
+    const std::vector<double>& x2 = history[2];
+    for (size_t v = 0; v < rank.size(); v++) {
+        double d1 = x1[v] - x0[v];
+        double d2 = x2[v] - x1[v];
+        double curvature = d2 - d1;
+        if (d1 * d2 > 0.0 && std::fabs(d2) < std::fabs(d1)) {
+            rank[v] = x2[v] - d2 * d2 / curvature;
+        }
+    }
+    normalizeRank(rank);
+}
+
+// Quadratic extrapolation (Kamvar et al.) over four successive iterates:
+// fits the two leading non-principal eigenvectors by least squares and
+// removes them
+void quadraticExtrapolate(const std::vector<std::vector<double>>& history, std::vector<double>& rank) {
+    const std::vector<double>& x0 = history[0];
+    const std::vector<double>& x1 = history[1];
+    const std::vector<double>& x2 = history[2];
+    const std::vector<double>& x3 = history[3];
+    double a11 = 0.0, a12 = 0.0, a22 = 0.0, b1 = 0.0, b2 = 0.0;
+    for (size_t v = 0; v < rank.size(); v++) {
+        double y1 = x1[v] - x0[v];
+        double y2 = x2[v] - x0[v];
+        double y3 = x3[v] - x0[v];
+        a11 += y1 * y1;
+        a12 += y1 * y2;
+        a22 += y2 * y2;
+        b1 -= y1 * y3;
+        b2 -= y2 * y3;
+    }
+    double det = a11 * a22 - a12 * a12;
+    if (!(std::fabs(det) > 1e-12 * a11 * a22)) return;  // iterates nearly collinear
+    double g1 = (b1 * a22 - b2 * a12) / det;
+    double g2 = (a11 * b2 - a12 * b1) / det;
+    double beta0 = g1 + g2 + 1.0;
+    double beta1 = g2 + 1.0;
+    for (size_t v = 0; v < rank.size(); v++) {
+        rank[v] = beta0 * x1[v] + beta1 * x2[v] + x3[v];
+    }
+    normalizeRank(rank);
+}
+
+}  // namespace
+
+PageRankStats PageRankEngine::solve(std::vector<double>& rank, const PageRankOptions& options,
+                                    const std::vector<double>* teleport) const {
+    typedef PageRankOptions::Method Method;
+    PageRankStats stats;
+    int window = options.method == Method::Aitken ? 3 : options.method == Method::Quadratic ? 4 : 0;
+    int interval = std::max(options.extrapolation_interval, window);
     
-    file << "}\n";
+    // Jacobi sweeps alternate between rank and next; a converged sweep's
+    // output is dropped, as its change was already below tolerance
+    std::vector<double> next;
+    std::vector<std::vector<double>> history(window);
+    int filled = 0;
+    for (stats.iterations = 0; stats.iterations < options.max_iterations; stats.iterations++) {
+        double diff = options.method == Method::GaussSeidel
+                          ? gaussSeidelSweep(rank, options.damping, teleport)
+                          : jacobiSweep(rank, next, options.damping, teleport, options.threads);
+        stats.residuals.push_back(diff);
+        if (diff < options.tolerance) {
+            stats.converged = true;
+            break;
+        }
+        if (options.method == Method::GaussSeidel) {
+            // In-place sweeps do not conserve mass; rescaling each sweep
+            // keeps the total from relaxing only at rate damping
+            normalizeRank(rank);
+            continue;
+        }
+        rank.swap(next);
+        
+        // Keep the last window iterates before each extrapolation point
+        int remaining = interval - 1 - stats.iterations % interval;
+        if (remaining < window) {
+            history[filled++] = rank;
+        }
+        if (window > 0 && remaining == 0 && filled == window) {
+            if (options.method == Method::Aitken) {
+                aitkenExtrapolate(history, rank);
+            } else {
+                quadraticExtrapolate(history, rank);
+            }
+            filled = 0;
+        }
+    }
+    if (options.method == Method::GaussSeidel) {
+        normalizeRank(rank);
+    }
+    return stats;
+}
+
+std::vector<std::pair<int, double>> topRanked(const std::vector<double>& ranks, int k) {
+    std::vector<int> ids(ranks.size());
+    for (size_t v = 0; v < ids.size(); v++) {
+        ids[v] = v;
+    }
+    k = std::max(0, std::min(k, static_cast<int>(ids.size())));
+    std::partial_sort(ids.begin(), ids.begin() + k, ids.end(), [&](int a, int b) {
+        return ranks[a] != ranks[b] ? ranks[a] > ranks[b] : a < b;
+    });
+    std::vector<std::pair<int, double>> top;
+    top.reserve(k);
+    for (int i = 0; i < k; i++) {
+        top.emplace_back(ids[i], ranks[ids[i]]);
+    }
+    return top;
+}
+
+PageRankResult computePageRank(const Graph& graph, const PageRankOptions& options, int top_k, ThreadPool* pool) {
+    PageRankResult result;
+    if (graph.numVertices == 0) return result;
     
-    std::cout << "Shortest path visualization generated with " << path_list.paths.size() 
-         << " paths. Run: dot -Tpng shortest_path.dot -o shortest_path.png" << std::endl;
+    PageRankEngine engine(graph, pool);
+    result.has_dangling = !engine.danglingVertices().empty();
+    result.ranks.assign(graph.numVertices, 1.0 / graph.numVertices);
+    result.stats = engine.solve(result.ranks, options);
+    if (top_k > 0) {
+        result.top = topRanked(result.ranks, top_k);
+    }
+    return result;
+}
+
+void printPageRank(const PageRankResult& result, const WordTable& table, std::ostream& out) {
+    if (result.has_dangling) {
+        out << "Warning: Graph contains dangling nodes (nodes with out-degree=0)\n";
+    }
+    out << "PageRank converged after " << result.stats.iterations << " iterations:\n";
+    out << std::fixed << std::setprecision(6);
+    if (!result.top.empty()) {
+        for (const std::pair<int, double>& entry : result.top) {
+            out << table.word(entry.first) << ": " << entry.second << '\n';
+        }
+    } else {
+        for (size_t v = 0; v < result.ranks.size(); v++) {
+            out << table.word(v) << ": " << result.ranks[v] << '\n';
+        }
+    }
+    out.flush();
 }
 
-void calculatePageRank(const Graph& graph, const WordTable& table) {
+void calculatePageRank(const Graph& graph, const WordTable& table, const PageRankOptions& options, int top_k,
+                       ThreadPool* pool) {
     if (graph.numVertices == 0) {
         std::cout << "Graph is empty!" << std::endl;
         return;
     }
+    printPageRank(computePageRank(graph, options, top_k, pool), table);
+}
 
-    int numVertices = graph.numVertices;
-    std::vector<double> pr(numVertices, 1.0 / numVertices);
-    std::vector<double> new_pr(numVertices);
-    std::vector<int> out_degree(numVertices, 0);
-    bool has_out_degree_zero = false;
+std::vector<double> personalizedPageRank(const PageRankEngine& engine, const std::vector<int>& seeds,
+                                         double damping) {
+    int n = engine.numVertices();
+    std::vector<double> teleport(n, 0.0);
+    for (int seed : seeds) {
+        teleport[seed] += 1.0 / seeds.size();
+    }
+    std::vector<double> rank = teleport;
+    if (seeds.empty()) return rank;
+    engine.run(rank, damping, MAX_ITERATIONS, TOLERANCE, &teleport);
+    return rank;
+}
 
-    for (int i = 0; i < numVertices; i++) {
-        for (int j = 0; j < numVertices; j++) {
-            if (graph.adjacencyMatrix[i][j] > 0) {
-                out_degree[i] += graph.adjacencyMatrix[i][j];
-            }
+std::vector<std::pair<int, double>> approximatePersonalizedPageRank(const Graph& graph, const std::vector<int>& seeds,
+                                                                    double damping, double epsilon) {
+    // Forward push keeps rank + PPR(residual) equal to the exact answer and
+    // only visits vertices whose residual is large relative to their degree
+    std::unordered_map<int, double> rank, residual;
+    std::unordered_map<int, int> out_weight;
+    std::queue<int> active;
+    auto weightOf = [&](int u) {
+        auto it = out_weight.find(u);
+        if (it != out_weight.end()) return it->second;
+        int total = 0;
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            total += graph.edgeWeights[e];
         }
+        out_weight.emplace(u, total);
+        return total;
+    };
+    auto threshold = [&](int u) { return epsilon * std::max(1, weightOf(u)); };
+    auto addResidual = [&](int v, double mass) {
+        double& r = residual[v];
+        bool was_active = r >= threshold(v);
+        r += mass;
+        if (!was_active && r >= threshold(v)) active.push(v);
+    };
+    
+    for (int seed : seeds) {
+        addResidual(seed, 1.0 / seeds.size());
+    }
+    while (!active.empty()) {
+        int u = active.front();
+        active.pop();
+        double r = residual[u];
+        residual[u] = 0.0;
+        rank[u] += (1.0 - damping) * r;
         
-        if (out_degree[i] == 0) {
-            has_out_degree_zero = true;
+        int total = weightOf(u);
+        if (total == 0) {
+            // Dangling words hand their mass back to the seeds
+            for (int seed : seeds) {
+                addResidual(seed, damping * r / seeds.size());
+            }
+            continue;
+        }
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            addResidual(graph.columnIndices[e], damping * r * graph.edgeWeights[e] / total);
         }
     }
+    
+    std::vector<std::pair<int, double>> result(rank.begin(), rank.end());
+    std::sort(result.begin(), result.end(), [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return result;
+}
 
-    if (has_out_degree_zero) {
-        std::cout << "Warning: Graph contains dangling nodes (nodes with out-degree=0)" << std::endl;
+int updatePageRank(const Graph& before, const Graph& after, std::vector<double>& rank,
+                   double damping, double tolerance) {
+    // rank is converged on before; after keeps its word ids and may append
+    // new words. Residuals are tracked up to a uniform component: pushing a
+    // uniform residual only rescales the answer, so teleport and dangling
+    // terms are dropped and the result is renormalised at the end.
+    int old_n = before.numVertices;
+    int n = after.numVertices;
+    if (old_n == 0 || static_cast<int>(rank.size()) != old_n || n < old_n) {
+        rank.assign(n, n ? 1.0 / n : 0.0);
+        if (n) PageRankEngine(after).run(rank, damping, MAX_ITERATIONS, tolerance);
+        return 0;
     }
-
-    int iter;
-    double diff;
-    for (iter = 0; iter < MAX_ITERATIONS; iter++) {
-        diff = 0.0;
+    auto outWeight = [](const Graph& graph, int u) {
+        long long total = 0;
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            total += graph.edgeWeights[e];
+        }
+        return total;
+    };
+    
+    double old_dangling = 0.0;
+    for (int u = 0; u < old_n; u++) {
+        if (before.rowOffsets[u] == before.rowOffsets[u + 1]) old_dangling += rank[u];
+    }
+    double old_teleport = ((1.0 - damping) + damping * old_dangling) / old_n;
+    rank.resize(n, 0.0);
+    
+    // Seed residuals from the rows that changed: new words, and old words
+    // whose out-edges differ, move their pull from old to new targets
+    std::vector<double> residual(n, 0.0);
+    for (int v = old_n; v < n; v++) {
+        residual[v] = old_teleport;
+    }
+    for (int u = 0; u < old_n; u++) {
+        int old_begin = before.rowOffsets[u], old_end = before.rowOffsets[u + 1];
+        int new_begin = after.rowOffsets[u], new_end = after.rowOffsets[u + 1];
+        if (old_end - old_begin == new_end - new_begin &&
+            std::equal(before.columnIndices.begin() + old_begin, before.columnIndices.begin() + old_end,
+                       after.columnIndices.begin() + new_begin) &&
+            std::equal(before.edgeWeights.begin() + old_begin, before.edgeWeights.begin() + old_end,
+                       after.edgeWeights.begin() + new_begin)) {
+            continue;
+        }
+        if (old_end > old_begin) {
+            double share = damping * rank[u] / outWeight(before, u);
+            for (int e = old_begin; e < old_end; e++) {
+                residual[before.columnIndices[e]] -= share * before.edgeWeights[e];
+            }
+        }
+        if (new_end > new_begin) {
+            double share = damping * rank[u] / outWeight(after, u);
+            for (int e = new_begin; e < new_end; e++) {
+                residual[after.columnIndices[e]] += share * after.edgeWeights[e];
+            }
+        }
+    }
+    
+    double threshold = tolerance / n;
+    std::queue<int> active;
+    std::vector<bool> queued(n, false);
+    for (int v = 0; v < n; v++) {
+        if (std::fabs(residual[v]) > threshold) {
+            active.push(v);
+            queued[v] = true;
+        }
+    }
+    int pushes = 0;
+    while (!active.empty()) {
+        int u = active.front();
+        active.pop();
+        queued[u] = false;
+        double r = residual[u];
+        residual[u] = 0.0;
+        rank[u] += r;
+        pushes++;
         
-        double dangling_contribution = 0.0;
-        for (int i = 0; i < numVertices; i++) {
-            if (out_degree[i] == 0) {
-                dangling_contribution += pr[i] / numVertices;
+        long long total = outWeight(after, u);
+        if (total == 0) continue;  // dangling mass spreads uniformly
+        double share = damping * r / total;
+        for (int e = after.rowOffsets[u]; e < after.rowOffsets[u + 1]; e++) {
+            int v = after.columnIndices[e];
+            residual[v] += share * after.edgeWeights[e];
+            if (!queued[v] && std::fabs(residual[v]) > threshold) {
+                active.push(v);
+                queued[v] = true;
             }
         }
+    }
+    
+    double sum = 0.0;
+    for (double r : rank) {
+        sum += r;
+    }
+    for (double& r : rank) {
+        r /= sum;
+    }
+    return pushes;
+}
 
-        for (int j = 0; j < numVertices; j++) {
-            new_pr[j] = (1.0 - DAMPING_FACTOR) / numVertices;
-            
-            for (int i = 0; i < numVertices; i++) {
-                if (graph.adjacencyMatrix[i][j] > 0 && out_degree[i] > 0) {
-                    new_pr[j] += DAMPING_FACTOR * pr[i] * graph.adjacencyMatrix[i][j] / out_degree[i];
+MonteCarloPageRank monteCarloPageRank(const Graph& graph, int walks_per_vertex, double damping, uint64_t seed,
+                                      ThreadPool* pool) {
+    const int MAX_BATCHES = 16;
+    int n = graph.numVertices;
+    MonteCarloPageRank result;
+    if (n == 0 || walks_per_vertex <= 0) return result;
+    
+    // Running edge weight within each CSR row, so a weighted step is a
+    // binary search of the row
+    std::vector<long long> cumulative(graph.numEdges());
+    for (int u = 0; u < n; u++) {
+        long long total = 0;
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            total += graph.edgeWeights[e];
+            cumulative[e] = total;
+        }
+    }
+    
+    int batches = std::min(walks_per_vertex, MAX_BATCHES);
+    std::vector<std::vector<int>> visits(batches, std::vector<int>(n, 0));
+    std::vector<long long> batch_visits(batches, 0);
+    std::atomic<int> next_batch(0);
+    auto work = [&](int) {
+        for (int b = next_batch++; b < batches; b = next_batch++) {
+            std::mt19937_64 gen(seed * 0x9E3779B97F4A7C15ULL + b);
+            std::geometric_distribution<int> length(1.0 - damping);
+            std::uniform_int_distribution<int> jump(0, n - 1);
+            int walks = walks_per_vertex / batches + (b < walks_per_vertex % batches);
+            std::vector<int>& count = visits[b];
+            long long total = 0;
+            for (int start = 0; start < n; start++) {
+                for (int w = 0; w < walks; w++) {
+                    int u = start;
+                    count[u]++;
+                    for (int step = length(gen); step > 0; step--) {
+                        int begin = graph.rowOffsets[u], end = graph.rowOffsets[u + 1];
+                        if (begin == end) {
+                            u = jump(gen);
+                        } else {
+                            long long pick = std::uniform_int_distribution<long long>(0, cumulative[end - 1] - 1)(gen);
+                            u = graph.columnIndices[std::upper_bound(cumulative.begin() + begin,
+                                                                     cumulative.begin() + end, pick) -
+                                                    cumulative.begin()];
+                        }
+                        count[u]++;
+                    }
                 }
             }
-            
-            new_pr[j] += DAMPING_FACTOR * dangling_contribution;
-            
-            diff += abs(new_pr[j] - pr[j]);
+            for (int v = 0; v < n; v++) {
+                total += count[v];
+            }
+            batch_visits[b] = total;
         }
-
-        if (diff < TOLERANCE) {
-            break;
+    };
+    if (pool && pool->size() > 1 && batches > 1) {
+        pool->run(work);
+    } else {
+        work(0);
+    }
+    
+    long long total = 0;
+    for (long long t : batch_visits) {
+        total += t;
+    }
+    result.steps = total - static_cast<long long>(n) * walks_per_vertex;
+    result.ranks.assign(n, 0.0);
+    // Student t 97.5% quantiles for batches - 1 degrees of freedom; a
+    // single batch has no spread to measure, so its interval is unbounded
+    static const double T_QUANTILE[MAX_BATCHES] = {0.0,   12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365,
+                                                   2.306, 2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131};
+    result.half_width.assign(n, std::numeric_limits<double>::infinity());
+    for (int v = 0; v < n; v++) {
+        long long hits = 0;
+        for (int b = 0; b < batches; b++) {
+            hits += visits[b][v];
         }
-
-        pr = new_pr;
+        result.ranks[v] = static_cast<double>(hits) / total;
+        if (batches < 2) continue;
+        double variance = 0.0;
+        for (int b = 0; b < batches; b++) {
+            double deviation = static_cast<double>(visits[b][v]) / batch_visits[b] - result.ranks[v];
+            variance += deviation * deviation;
+        }
+        variance /= batches - 1;
+        result.half_width[v] = T_QUANTILE[batches - 1] * std::sqrt(variance / batches);
     }
+    return result;
+}
 
-    std::cout << "PageRank converged after " << iter << " iterations:" << std::endl;
-    for (int i = 0; i < numVertices; i++) {
-        std::cout << table.words[i] << ": " << std::fixed << std::setprecision(6) << pr[i] << std::endl;
+void showRelatedWords(const Graph& graph, const WordTable& table, const std::vector<std::string>& seeds, int k) {
+    std::vector<int> ids;
+    for (const std::string& word : seeds) {
+        int id = table.getIndex(word);
+        if (id == -1) {
+            std::cout << "No " << word << " in the graph!" << std::endl;
+            continue;
+        }
+        ids.push_back(id);
+    }
+    if (ids.empty()) return;
+    
+    std::vector<std::pair<int, double>> related = approximatePersonalizedPageRank(graph, ids);
+    std::cout << "Words most related to the seeds:" << std::endl;
+    for (int i = 0; i < k && i < static_cast<int>(related.size()); i++) {
+        std::cout << table.word(related[i].first) << ": " << std::fixed << std::setprecision(6)
+                  << related[i].second << std::endl;
     }
 }
 
@@ -645,9 +3401,9 @@ void randomWalk(const Graph& graph, const WordTable& table) {
     static std::mt19937 gen(rd());
     std::uniform_int_distribution<> dis(0, graph.numVertices - 1);
     int current = dis(gen);
-    std::cout << "Start at: " << table.words[current] << std::endl;
-    walk_file << "Start at: " << table.words[current] << std::endl;
-    std::vector<std::vector<bool>> visited_edges(graph.numVertices, std::vector<bool>(graph.numVertices, false));
+    std::cout << "Start at: " << table.word(current) << std::endl;
+    walk_file << "Start at: " << table.word(current) << std::endl;
+    std::vector<bool> visited_edges(graph.numEdges(), false);
     int steps = 0;
     bool stop = false;
     while (!stop) {
@@ -658,41 +3414,29 @@ void randomWalk(const Graph& graph, const WordTable& table) {
             stop = true;
             break;
         }
-        bool has_out_edge = false;
-        for (int i = 0; i < graph.numVertices; i++) {
-            if (graph.adjacencyMatrix[current][i] > 0) {
-                has_out_edge = true;
-                break;
-            }
-        }
-        if (!has_out_edge) {
-            std::cout << "\nStopped at node " << table.words[current] 
+        if (graph.outDegree(current) == 0) {
+            std::cout << "\nStopped at node " << table.word(current) 
                  << " (no outgoing edges)." << std::endl;
-            walk_file << "\nStopped at node " << table.words[current] 
+            walk_file << "\nStopped at node " << table.word(current) 
                       << " (no outgoing edges)." << std::endl;
             break;
         }
-        std::vector<int> out_edges;
-        for (int i = 0; i < graph.numVertices; i++) {
-            if (graph.adjacencyMatrix[current][i] > 0) {
-                out_edges.push_back(i);
-            }
-        }
-        std::uniform_int_distribution<> edge_dis(0, out_edges.size() - 1);
-        int next = out_edges[edge_dis(gen)];
+        std::uniform_int_distribution<> edge_dis(graph.rowOffsets[current], graph.rowOffsets[current + 1] - 1);
+        int edge = edge_dis(gen);
+        int next = graph.columnIndices[edge];
         steps++;
-        if (visited_edges[current][next]) {
-            std::cout << "\nStopped at edge " << table.words[current] << " -> " 
-                 << table.words[next] << " (repeated edge)." << std::endl;
-            walk_file << "\nStopped at edge " << table.words[current] << " -> " 
-                      << table.words[next] << " (repeated edge)." << std::endl;
+        if (visited_edges[edge]) {
+            std::cout << "\nStopped at edge " << table.word(current) << " -> " 
+                 << table.word(next) << " (repeated edge)." << std::endl;
+            walk_file << "\nStopped at edge " << table.word(current) << " -> " 
+                      << table.word(next) << " (repeated edge)." << std::endl;
             break;
         }
-        visited_edges[current][next] = true;
-        std::cout << "Step " << steps << ": " << table.words[current] << " -> " 
-             << table.words[next] << std::endl;
-        walk_file << "Step " << steps << ": " << table.words[current] << " -> " 
-                  << table.words[next] << std::endl;
+        visited_edges[edge] = true;
+        std::cout << "Step " << steps << ": " << table.word(current) << " -> " 
+             << table.word(next) << std::endl;
+        walk_file << "Step " << steps << ": " << table.word(current) << " -> " 
+                  << table.word(next) << std::endl;
         current = next;
     }
     std::cout << "Random walk completed. Total steps: " << steps << std::endl;
@@ -704,18 +3448,14 @@ void randomWalk(const Graph& graph, const WordTable& table) {
 // int main() {
 //     std::srand(std::time(nullptr));
     
-//     std::string processed_text = processTextFile("Easy Test.txt");
-//     if (!processed_text.empty()) {
-//         std::cout << "Processed text: " << processed_text << std::endl;
-        
-//         WordNode* word_list = sentenceToList(processed_text);
-//         WordTable table;
-        
-//         populateWordTable(word_list, table);
+//     WordTable table;
+//     std::vector<int> tokens = tokenizeTextFile("Easy Test.txt", table);
+//     if (!tokens.empty()) {
+//         std::cout << "Processed " << tokens.size() << " words." << std::endl;
         
 //         if (table.size() > 0) {
 //             Graph graph(table.size());
-//             buildGraph(word_list, graph, table);
+//             buildGraph(tokens, graph);
             
 //             exportToDot(graph, table, "graph.dot");
 //             std::cout << "DOT file generated. Run: dot -Tpng graph.dot -o graph.png" << std::endl;
@@ -745,11 +3485,6 @@ void randomWalk(const Graph& graph, const WordTable& table) {
 //                 switch (choice) {
 //                     case 0:
 //                         std::cout << "Exiting program." << std::endl;
-//                         while (word_list) {
-//                             WordNode* next_node = word_list->next;
-//                             delete word_list;
-//                             word_list = next_node;
-//                         }
 //                         return 0;
                         
 //                     case 1:
@@ -5,17 +5,29 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cctype>
+#include <cstdint>
 #include <ctime>
 #include <climits>
 #include <cmath>
 #include <algorithm>
+#include <memory>
 #include <unordered_map>
+#include <set>
 #include <queue>
 #include <random>
 #include <iomanip>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-const int MAX_VERTICES = 100;
 const int MAX_WORD_LEN = 20;
 const int MAX_PATHS = 10;
 const double DAMPING_FACTOR = 0.85;
@@ -25,6 +37,27 @@ const double TOLERANCE = 1e-6;
 // Convert character to lowercase
 char toLower(char c);
 
+inline bool isAsciiLetter(char c) {
+    return static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+}
+
+inline int lowestSetBit(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Bit i of the result is set when p[i] is an ASCII letter. Reads 32 bytes;
+// uses AVX2 or SSE2 when the CPU supports it.
+uint32_t letterMask32(const char* p);
+
+// Copy n bytes from src to dst lowercasing ASCII letters. dst may equal src.
+void lowerAscii(char* dst, const char* src, size_t n);
+
 // WordNode class for linked list
 class WordNode {
 public:
@@ -34,49 +67,611 @@ public:
     WordNode(const std::string& w);
 };
 
-// Graph class using adjacency matrix
+// Graph class using compressed sparse row (CSR) adjacency.
+// Edges are staged with addEdge() and packed by finalize(), which merges
+// duplicate edges by summing their weights. Each row is sorted by target.
+// finalize() also builds the reverse (in-edge) CSR, sorted by source.
 class Graph {
 public:
     int numVertices;
-    std::vector<std::vector<int>> adjacencyMatrix;
+    std::vector<int> rowOffsets;     // numVertices + 1 entries
+    std::vector<int> columnIndices;  // edge targets
+    std::vector<int> edgeWeights;    // edge weights
+    std::vector<int> inOffsets;      // numVertices + 1 entries
+    std::vector<int> inSources;      // in-edge sources
+    std::vector<int> inWeights;      // in-edge weights
 
     Graph(int vertices);
+
+    void addEdge(int from, int to, int weight = 1);
+    void finalize();
+    int numEdges() const;
+    int outDegree(int vertex) const;
+    int edgeIndex(int from, int to) const;
+    int edgeWeight(int from, int to) const;
+
+private:
+    struct PendingEdge {
+        int from;
+        int to;
+        int weight;
+    };
+    std::vector<PendingEdge> pendingEdges;
 };
 
-// WordTable class to maintain word to index mapping
+// WordTable class to maintain word to index mapping. Word bytes are interned
+// in a bump-allocated arena and ids are dense; the open-addressing hash index
+// stores only ids and hash tags. Lookups take any character range and never
+// allocate; callers that probe the same word repeatedly can pass hash().
+// freeze() replaces the index with a minimal perfect hash for read-only use;
+// adding a word afterwards thaws the table again.
 class WordTable {
 public:
-    std::vector<std::string> words;
-    std::unordered_map<std::string, int> wordToIndex;
+    WordTable();
+
+    static uint64_t hash(std::string_view word);
+
+    int addWord(std::string_view word);
+    int addWord(std::string_view word, uint64_t hash);
+    int getIndex(std::string_view word) const;
+    int getIndex(std::string_view word, uint64_t hash) const;
+    std::string_view word(int id) const;
+    size_t size() const;
+
+    bool freeze();
+    bool isFrozen() const;
+
+private:
+    static const uint32_t BLOCK_BITS = 16;
+    static const uint32_t DIRECT_PILOT = 0x80000000u;
+    static const uint32_t BLOCK_SIZE = 1u << BLOCK_BITS;
+
+    // Upper 32 bits of the hash pick the home slot and filter compares
+    struct Slot {
+        uint32_t id;   // id + 1, or 0 when empty
+        uint32_t tag;
+    };
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    uint32_t blockUsed;
+    std::vector<uint32_t> offsets;  // block << BLOCK_BITS | position
+    std::vector<uint32_t> lengths;
+    std::vector<Slot> slots;
+
+    // Frozen index: a bucket's pilot either offsets its keys' hash or, with
+    // DIRECT_PILOT set, names the slot of its single key outright
+    bool frozen;
+    std::vector<uint32_t> pilots;
+    std::vector<uint32_t> perfectIds;
+
+    uint32_t intern(std::string_view word);
+    size_t findSlot(std::string_view word, uint32_t tag) const;
+    void growIndex();
+    void thaw();
+    size_t perfectBucket(uint64_t hash) const;
+    size_t perfectSlot(uint64_t hash, uint32_t pilot) const;
+};
+
+// Read-only view of a whole file, memory-mapped where the platform allows
+// and read into memory otherwise.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
-    int addWord(const std::string& word);
-    int getIndex(const std::string& word) const;
+    bool isOpen() const;
+    const char* data() const;
     size_t size() const;
+
+private:
+    bool opened;
+    const char* mappedData;
+    size_t mappedSize;
+    void* fileHandle;
+    void* mappingHandle;
+    std::vector<char> buffer;
+};
+
+// Call emit(begin, end) for every maximal run of ASCII letters in
+// [data, data + size), classifying 32 bytes at a time.
+template <typename Emit>
+void forEachLetterRun(const char* data, size_t size, Emit&& emit) {
+    bool in_run = false;
+    size_t run_start = 0;
+    for (size_t base = 0; base < size; base += 32) {
+        size_t count = std::min<size_t>(32, size - base);
+        uint64_t letters;
+        if (count == 32) {
+            letters = letterMask32(data + base);
+        } else {
+            letters = 0;
+            for (size_t i = 0; i < count; i++) {
+                letters |= static_cast<uint64_t>(isAsciiLetter(data[base + i])) << i;
+            }
+        }
+
+        // Set bits mark positions where a run starts or ends
+        uint64_t edges = (letters ^ ((letters << 1) | (in_run ? 1 : 0))) &
+                         ((static_cast<uint64_t>(1) << count) - 1);
+        while (edges) {
+            size_t pos = base + lowestSetBit(edges);
+            edges &= edges - 1;
+            if (in_run) {
+                emit(run_start, pos);
+            } else {
+                run_start = pos;
+            }
+            in_run = !in_run;
+        }
+    }
+    if (in_run) {
+        emit(run_start, size);
+    }
+}
+
+// Call emit(std::string_view) for every lowercase word in [data, data + size).
+// Words are runs of ASCII letters split every MAX_WORD_LEN - 1 characters,
+// matching processTextFile followed by sentenceToList.
+template <typename Emit>
+void forEachWord(const char* data, size_t size, Emit&& emit) {
+    char word[MAX_WORD_LEN];
+    forEachLetterRun(data, size, [&](size_t begin, size_t end) {
+        while (begin < end) {
+            size_t len = std::min<size_t>(MAX_WORD_LEN - 1, end - begin);
+            for (size_t i = 0; i < len; i++) {
+                word[i] = data[begin + i] | 0x20;
+            }
+            emit(std::string_view(word, len));
+            begin += len;
+        }
+    });
+}
+
+// Streaming graph construction. Words are interned and bigrams counted as
+// they arrive, so only the vocabulary and distinct edges are kept in memory.
+class GraphBuilder {
+public:
+    explicit GraphBuilder(WordTable& table);
+
+    void addWord(std::string_view word);
+    void addText(const char* data, size_t size);
+    void endText();
+    Graph finish();
+
+    const std::unordered_map<uint64_t, int>& edgeCounts() const;
+    int firstWord() const;
+    int lastWord() const;
+
+private:
+    WordTable& table;
+    std::unordered_map<uint64_t, int> edges;
+    int first;
+    int last;
+    std::string partialWord;
+};
+
+// Bridge words of (id1, id2) are out(id1) intersected with in(id2). Both CSR
+// rows are sorted, so pairs are merged, galloping through the longer row
+// when the lengths are lopsided. Hub words, whose degree is at least 1/32 of
+// the vertex count, also get a bitset over all words, which is smaller than
+// their row; two hubs are intersected 64 words at a time and a hub against
+// a short row by bit tests. A query never scans all V words.
+class BridgeWordIndex {
+public:
+    explicit BridgeWordIndex(const Graph& graph);
+
+    // Bridge word ids in increasing order
+    void find(int id1, int id2, std::vector<int>& bridges) const;
+
+private:
+    const Graph& graph;
+    int words;  // 64-bit words per bitset
+    std::vector<int> outSlot;  // bitset number per word, -1 if not a hub
+    std::vector<int> inSlot;
+    std::vector<uint64_t> outBits;
+    std::vector<uint64_t> inBits;
+};
+
+// Fixed set of worker threads. run(task) calls task(thread) once on every
+// thread, the caller acting as thread 0, and returns when all have finished.
+// Overlapping run() calls from different threads are served one at a time;
+// a task must not call run() on its own pool.
+class ThreadPool {
+public:
+    explicit ThreadPool(int num_threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const;
+    void run(const std::function<void(int)>& task);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex dispatch;  // held by the caller for a whole run()
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(int)>* current;
+    uint64_t generation;
+    int pending;
+    bool stopping;
+
+    void workerLoop(int thread);
+};
+
+// Per-query search state reused across queries. Distances, parents and
+// settled flags are stamped with the query epoch, so reset() is O(1) and the
+// arrays are only reallocated when the graph grows. The heap buffer is kept
+// too, so a warm workspace answers queries without touching the allocator.
+class SearchWorkspace {
+public:
+    SearchWorkspace();
+
+    void reset(int num_vertices);
+
+    int distance(int v) const { return stamp[v] == epoch ? dist[v] : INT_MAX; }
+    int parent(int v) const { return stamp[v] == epoch ? parents[v] : -1; }
+    bool settled(int v) const { return settledStamp[v] == epoch; }
+    void label(int v, int distance, int parent) {
+        stamp[v] = epoch;
+        dist[v] = distance;
+        parents[v] = parent;
+    }
+    void settle(int v) { settledStamp[v] = epoch; }
+
+    // Min-heap of (key, vertex), popped in the same order as a
+    // std::priority_queue with std::greater
+    bool empty() const { return heap.empty(); }
+    size_t heapSize() const { return heap.size(); }
+    const std::pair<int, int>& top() const { return heap.front(); }
+    void push(int key, int v) {
+        heap.emplace_back(key, v);
+        std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<int, int>>());
+    }
+    void pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<int, int>>());
+        heap.pop_back();
+    }
+    void clearHeap() { heap.clear(); }
+
+    // Dense copies for callers that keep per-vertex vectors
+    void copyDistances(std::vector<int>& out) const;
+    void copyParents(std::vector<int>& out) const;
+
+private:
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> settledStamp;
+    std::vector<int> dist;
+    std::vector<int> parents;
+    std::vector<std::pair<int, int>> heap;
+    uint32_t epoch;
+};
+
+// Shortest-path counts per vertex, stamped with an epoch like SearchWorkspace
+// so reset() is O(1). A vertex is seen once it has been given a count.
+class PathCounts {
+public:
+    PathCounts();
+
+    void reset(int num_vertices);
+
+    bool seen(int v) const { return stamp[v] == epoch; }
+    uint64_t count(int v) const { return stamp[v] == epoch ? counts[v] : 0; }
+    void set(int v, uint64_t count) {
+        stamp[v] = epoch;
+        counts[v] = count;
+    }
+
+private:
+    std::vector<uint32_t> stamp;
+    std::vector<uint64_t> counts;
+    uint32_t epoch;
+};
+
+// Forward and backward workspaces for one caller's point-to-point queries
+struct QueryContext {
+    SearchWorkspace forward;
+    SearchWorkspace backward;
+    PathCounts paths;  // for a ShortestPathDag over this context
+};
+
+// Scratch buffers for deltaStepping, kept across calls so repeated
+// one-to-all queries do not reallocate them
+struct DeltaSteppingWorkspace {
+    std::vector<std::atomic<int>> tentative;
+    std::vector<int> queuedIn;
+    std::vector<std::vector<int>> buckets;
+    std::vector<std::vector<int>> improved;  // per thread
+    std::vector<int> frontier;
+    std::vector<int> settled;
 };
 
 // PathList structure for storing multiple paths
 struct PathList {
     std::vector<std::vector<int>> paths;
     std::vector<int> path_lengths;
+    std::vector<int> path_weights;  // sum of edge weights along each path
+    uint64_t total_paths = 0;  // all shortest paths, saturating
+};
+
+// Shortest-path DAG from source to target. dist must be exact on every vertex
+// of a shortest path and, below dist[target], a lower bound or exact elsewhere
+// (as left by dijkstra or bidirectionalDijkstra). Paths are counted once by
+// dynamic programming in O(V + E) and enumerated lazily in edge order, so
+// asking for N paths costs O(N * length).
+class ShortestPathDag {
+public:
+    ShortestPathDag(const Graph& graph, int source, int target, const std::vector<int>& dist);
+    // Labels come straight from a context left by bidirectionalDijkstra,
+    // which returned distance, and counts go to its epoch-stamped table, so
+    // only the vertices the walk touches cost anything
+    ShortestPathDag(const Graph& graph, int source, int target, int distance, QueryContext& context);
+    // Labels are the vertices settled in workspace, as left by a search
+    // that returned distance (LandmarkIndex::query); the rest are unreached
+    ShortestPathDag(const Graph& graph, int source, int target, int distance, const SearchWorkspace& workspace,
+                    PathCounts& counts);
+    ShortestPathDag(const ShortestPathDag&) = delete;
+    ShortestPathDag& operator=(const ShortestPathDag&) = delete;
+
+    int distance() const;
+    uint64_t pathCount() const;
+    bool nextPath(std::vector<int>& path);
+
+private:
+    const Graph& graph;
+    const std::vector<int>* dist;  // null when labels come from a workspace
+    const QueryContext* context;
+    const SearchWorkspace* settledLabels;
+    int source;
+    int target;
+    int targetDistance;
+    PathCounts ownCounts;
+    PathCounts& pathsToTarget;
+    std::vector<int> pathEdges;  // edge taken at each depth of the walk
+    bool started;
+
+    int label(int v) const;
+    void countPaths();
+    bool onDag(int from, int edge) const;
+};
+
+// ALT index: distances to and from a few landmark words give triangle
+// inequality lower bounds, which steer A* through a narrow corridor of the
+// graph on repeated point-to-point queries. The graph must outlive it.
+class LandmarkIndex {
+public:
+    LandmarkIndex(const Graph& graph, int num_landmarks = 8);
+
+    const std::vector<int>& landmarks() const;
+    int lowerBound(int from, int to) const;
+    int query(int source, int target, std::vector<int>& dist) const;
+    int query(int source, int target, SearchWorkspace& workspace) const;
+
+private:
+    const Graph& graph;
+    std::vector<int> landmarkIds;
+    std::vector<int> fromLandmark;  // [vertex * landmarks + k] = d(landmark k, vertex)
+    std::vector<int> toLandmark;    // [vertex * landmarks + k] = d(vertex, landmark k)
+};
+
+// Contraction hierarchy for read-only deployments. Built offline by
+// contracting words in order of importance and adding shortcut edges; a
+// query is a bidirectional search over upward edges only, and shortcuts are
+// unpacked back into word paths. save() and load() persist the index along
+// with the vertex count, edge count and a checksum of the graph's CSR; load()
+// rejects a file built from a different graph or failing its consistency
+// checks, and leaves the hierarchy empty.
+class ContractionHierarchy {
+public:
+    ContractionHierarchy();
+    explicit ContractionHierarchy(const Graph& graph);
+
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename, const Graph& graph);
+
+    int numVertices() const;
+    int numShortcuts() const;
+    int query(int source, int target, std::vector<int>& path) const;
+    int query(int source, int target, std::vector<int>& path, QueryContext& context) const;
+
+private:
+    std::vector<int> rank;
+    // Edges to higher-ranked targets, per source, sorted by target
+    std::vector<int> upOffsets, upTargets, upWeights, upMiddles;
+    // Edges from higher-ranked sources, per target, sorted by source
+    std::vector<int> downOffsets, downSources, downWeights, downMiddles;
+
+    int graphEdges;
+    uint64_t graphChecksum;
+
+    void unpackEdge(int from, int to, int middle, std::vector<int>& path) const;
+    int findMiddle(int from, int to) const;
+    int findEdge(int from, int to) const;  // packed index in up or down, or -1
+    bool consistent() const;
+};
+
+// All-pairs shortest path lengths, precomputed once and stored row-major as
+// 16-bit saturating distances so later queries are table lookups. Sparse
+// graphs run one Dijkstra per source in parallel; dense ones use a
+// cache-blocked Floyd-Warshall.
+class DistanceMatrix {
+public:
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+    static constexpr uint16_t SATURATED = 0xFFFE;  // longer paths are clamped here
+
+    enum class Method { Auto, PerSourceDijkstra, BlockedFloydWarshall };
+
+    explicit DistanceMatrix(const Graph& graph, Method method = Method::Auto, int num_threads = 0);
+
+    int numVertices() const;
+    const uint16_t* row(int from) const;
+    int distance(int from, int to) const;  // INT_MAX if unreachable
+    bool shortestPath(int from, int to, std::vector<int>& path) const;
+
+private:
+    static const int BLOCK = 64;
+
+    const Graph& graph;
+    int n;
+    std::vector<uint16_t> dist;
+
+    void fillByDijkstra(int num_threads);
+    void fillByFloydWarshall(int num_threads);
+    void relaxBlock(int ib, int jb, int kb);
+};
+
+// Runtime solver settings for PageRankEngine::solve
+struct PageRankOptions {
+    // Jacobi is the plain power iteration and the only method that uses the
+    // thread pool. GaussSeidel updates ranks in place, reading values already
+    // refreshed in the same sweep. Aitken and Quadratic run Jacobi sweeps and
+    // periodically extrapolate from the last few iterates.
+    enum class Method { Jacobi, GaussSeidel, Aitken, Quadratic };
+
+    double damping = DAMPING_FACTOR;
+    int max_iterations = MAX_ITERATIONS;
+    double tolerance = TOLERANCE;  // on the L1 change of one sweep
+    Method method = Method::Jacobi;
+    int threads = 0;  // upper bound on pool threads used, 0 for all
+    int extrapolation_interval = 10;  // sweeps between extrapolations
+};
+
+struct PageRankStats {
+    int iterations = 0;
+    bool converged = false;
+    std::vector<double> residuals;  // L1 change of every sweep
+};
+
+// Ranks from computePageRank. top lists the top_k vertices by rank, highest
+// first and ties by id, and is empty when no top_k was requested.
+struct PageRankResult {
+    std::vector<double> ranks;
+    std::vector<std::pair<int, double>> top;
+    PageRankStats stats;
+    bool has_dangling = false;
+};
+
+struct MonteCarloPageRank {
+    std::vector<double> ranks;
+    // Of a 95% confidence interval, from the Student t spread of the batch
+    // estimates; infinite when there was only one batch
+    std::vector<double> half_width;
+    long long steps = 0;  // walk steps taken in total
+};
+
+// PageRank over the in-edge CSR. Each in-edge carries its pull factor
+// weight / out_weight(source), stored contiguously in in-edge order, so an
+// iteration streams the factor and source arrays once and never divides.
+// With a pool, fixed-size blocks of destination vertices are shared among
+// the threads; reductions are summed per block and then in block order, so
+// results are bit-identical for any thread count. The graph (and pool)
+// must outlive the engine.
+class PageRankEngine {
+public:
+    explicit PageRankEngine(const Graph& graph, ThreadPool* pool = nullptr);
+
+    int numVertices() const;
+    const std::vector<int>& danglingVertices() const;
+
+    // One Jacobi sweep: next = (1 - d) / N + d * (P^T rank + dangling / N).
+    // A teleport distribution replaces the uniform 1 / N in both places,
+    // giving personalized PageRank. Returns the L1 distance between rank
+    // and next.
+    double step(const std::vector<double>& rank, std::vector<double>& next, double damping,
+                const std::vector<double>* teleport = nullptr) const;
+    // Iterates from rank until the L1 change drops below tolerance
+    int run(std::vector<double>& rank, double damping = DAMPING_FACTOR,
+            int max_iterations = MAX_ITERATIONS, double tolerance = TOLERANCE,
+            const std::vector<double>* teleport = nullptr) const;
+    // As run, with the method and thread count chosen at runtime. rank is
+    // left normalised to sum 1.
+    PageRankStats solve(std::vector<double>& rank, const PageRankOptions& options,
+                        const std::vector<double>* teleport = nullptr) const;
+
+private:
+    static const int BLOCK = 2048;
+
+    const Graph& graph;
+    ThreadPool* pool;
+    std::vector<double> factors;
+    std::vector<int> dangling;
+
+    double danglingMass(const std::vector<double>& rank) const;
+    double jacobiSweep(const std::vector<double>& rank, std::vector<double>& next, double damping,
+                       const std::vector<double>* teleport, int threads) const;
+    double gaussSeidelSweep(std::vector<double>& rank, double damping, const std::vector<double>* teleport) const;
 };
 
 // Function declarations
 std::string processTextFile(const std::string& filename);
 WordNode* sentenceToList(const std::string& sentence);
 void printList(WordNode* head);
+std::vector<int> tokenizeTextFile(const std::string& filename, WordTable& table);
 void populateWordTable(WordNode* head, WordTable& table);
 void buildGraph(WordNode* head, Graph& graph, WordTable& table);
+void buildGraph(const std::vector<int>& tokens, Graph& graph);
+Graph buildGraphParallel(const char* data, size_t size, WordTable& table, int num_threads = 0);
+Graph buildGraphFromFile(const std::string& filename, WordTable& table, int num_threads = 0);
 void exportToDot(const Graph& graph, const WordTable& table, const std::string& filename);
 void printAdjacencyMatrix(const Graph& graph, const WordTable& table);
-void findBridgeWords(const Graph& graph, const WordTable& table, const std::string& word1, const std::string& word2);
+void findBridgeWords(const Graph& graph, const WordTable& table, std::string_view word1, std::string_view word2);
+// Bridge word ids from the sorted CSR rows alone, in increasing order
+void bridgeWords(const Graph& graph, int id1, int id2, std::vector<int>& bridges);
 std::string selectRandomBridgeWord(const Graph& graph, const WordTable& table, int id1, int id2);
+std::string selectRandomBridgeWord(const BridgeWordIndex& index, const WordTable& table, int id1, int id2);
 void generateNewText(const Graph& graph, const WordTable& table, const std::string& input_text);
-void backtrackPaths(const Graph& graph, int u, int v, const std::vector<int>& dist, 
-                   std::vector<int>& path, PathList& path_list);
+void dijkstra(const Graph& graph, int source, std::vector<int>& dist, std::vector<int>& prev, int target = -1);
+void deltaStepping(const Graph& graph, int source, std::vector<int>& dist, std::vector<int>& prev,
+                   ThreadPool& pool, int delta = 0);
+void deltaStepping(const Graph& graph, int source, std::vector<int>& dist, std::vector<int>& prev,
+                   ThreadPool& pool, DeltaSteppingWorkspace& workspace, int delta = 0);
+// Labels every vertex when target is -1, and then returns INT_MAX
+int dijkstra(const Graph& graph, int source, int target, SearchWorkspace& workspace);
+int bidirectionalDijkstra(const Graph& graph, int source, int target, std::vector<int>& dist);
+int bidirectionalDijkstra(const Graph& graph, int source, int target, QueryContext& context);
 PathList findAllShortestPaths(const Graph& graph, int id1, int id2, const std::vector<int>& dist);
+PathList findAllShortestPaths(ShortestPathDag& dag);
+PathList kShortestPaths(const Graph& graph, int source, int target, int k);
+// One-to-all queries (empty word2) use delta-stepping on pool when given,
+// and plain Dijkstra otherwise
 void showShortestPath(const Graph& graph, const WordTable& table, 
-                     const std::string& word1, const std::string& word2 = "");
-void calculatePageRank(const Graph& graph, const WordTable& table);
+                     const std::string& word1, const std::string& word2 = "", ThreadPool* pool = nullptr);
+void showShortestPath(const Graph& graph, const WordTable& table, const LandmarkIndex& index,
+                      const std::string& word1, const std::string& word2);
+void showShortestPath(const Graph& graph, const WordTable& table,
+                      const std::string& word1, const std::string& word2, int k);
+void showShortestPath(const Graph& graph, const WordTable& table, const DistanceMatrix& matrix,
+                      const std::string& word1, const std::string& word2 = "");
+void calculatePageRank(const Graph& graph, const WordTable& table,
+                       const PageRankOptions& options = PageRankOptions(), int top_k = 0,
+                       ThreadPool* pool = nullptr);
+std::vector<std::pair<int, double>> topRanked(const std::vector<double>& ranks, int k);
+// Sweeps run on pool when given, serially otherwise
+PageRankResult computePageRank(const Graph& graph, const PageRankOptions& options = PageRankOptions(), int top_k = 0,
+                               ThreadPool* pool = nullptr);
+// Prints the top list if there is one, otherwise every word in id order
+void printPageRank(const PageRankResult& result, const WordTable& table, std::ostream& out = std::cout);
+std::vector<double> personalizedPageRank(const PageRankEngine& engine, const std::vector<int>& seeds,
+                                         double damping = DAMPING_FACTOR);
+std::vector<std::pair<int, double>> approximatePersonalizedPageRank(const Graph& graph, const std::vector<int>& seeds,
+                                                                    double damping = DAMPING_FACTOR,
+                                                                    double epsilon = 1e-6);
+// Pushes rank, converged on before, to after and returns the pushes made.
+// Falls back to a full run from uniform ranks, returning 0, when rank does
+// not match before or after has fewer words.
+int updatePageRank(const Graph& before, const Graph& after, std::vector<double>& rank,
+                   double damping = DAMPING_FACTOR, double tolerance = TOLERANCE);
+// Monte Carlo PageRank from walks_per_vertex walks started at every word.
+// Walks stop with probability 1 - damping per step and follow edges in
+// proportion to their weight, jumping uniformly from dangling words; ranks
+// are visit frequencies. Walks run in fixed batches, each with its own
+// generator seeded from seed, so results do not depend on the pool size.
+MonteCarloPageRank monteCarloPageRank(const Graph& graph, int walks_per_vertex, double damping = DAMPING_FACTOR,
+                                      uint64_t seed = 1, ThreadPool* pool = nullptr);
+void showRelatedWords(const Graph& graph, const WordTable& table, const std::vector<std::string>& seeds, int k = 10);
 void randomWalk(const Graph& graph, const WordTable& table);
 
 #endif // MAIN2_H
\ No newline at end of file
@@ -60,9 +60,10 @@ TEST(RandomWalkTest, RepeatedEdgeTermination) {
     table.addWord("C");
     
     // 创建环状结构：A->B->C->A
-    graph.adjacencyMatrix[0][1] = 1; // A -> B
-    graph.adjacencyMatrix[1][2] = 1; // B -> C
-    graph.adjacencyMatrix[2][0] = 1; // C -> A
+    graph.addEdge(0, 1); // A -> B
+    graph.addEdge(1, 2); // B -> C
+    graph.addEdge(2, 0); // C -> A
+    graph.finalize();
 
     // 模拟用户输入，让程序走A->B->C->A->B (第二次A->B是重复边)
     std::streambuf* orig = std::cin.rdbuf();
@@ -92,9 +93,10 @@ TEST(RandomWalkTest, UserRequestedStop) {
     table.addWord("A");
     table.addWord("B");
     table.addWord("C");
-    graph.adjacencyMatrix[0][1] = 1; // A -> B
-    graph.adjacencyMatrix[1][2] = 1; // B -> C
-    graph.adjacencyMatrix[2][0] = 1; // C -> A (形成环)
+    graph.addEdge(0, 1); // A -> B
+    graph.addEdge(1, 2); // B -> C
+    graph.addEdge(2, 0); // C -> A (形成环)
+    graph.finalize();
 
     // 删除 executeAndPrintRandomWalk 调用，避免执行两次
     
@@ -133,10 +135,11 @@ TEST(RandomWalkTest, MultipleEdgesUntilRepeat) {
     table.addWord("A");
     table.addWord("B");
     table.addWord("C");
-    graph.adjacencyMatrix[0][1] = 1; // A -> B
-    graph.adjacencyMatrix[0][2] = 1; // A -> C
-    graph.adjacencyMatrix[1][0] = 1; // B -> A
-    graph.adjacencyMatrix[2][1] = 1; // C -> B
+    graph.addEdge(0, 1); // A -> B
+    graph.addEdge(0, 2); // A -> C
+    graph.addEdge(1, 0); // B -> A
+    graph.addEdge(2, 1); // C -> B
+    graph.finalize();
     
     executeAndPrintRandomWalk(graph, table, "MultipleEdgesUntilRepeat");
     
@@ -155,8 +158,9 @@ TEST(RandomWalkTest, WalkToDeadEnd) {
     table.addWord("A");
     table.addWord("B");
     table.addWord("C");
-    graph.adjacencyMatrix[0][1] = 1; // A -> B
-    graph.adjacencyMatrix[1][2] = 1; // B -> C (C无出边)
+    graph.addEdge(0, 1); // A -> B
+    graph.addEdge(1, 2); // B -> C (C无出边)
+    graph.finalize();
     
     executeAndPrintRandomWalk(graph, table, "WalkToDeadEnd");
     
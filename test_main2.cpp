@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <sstream>
 #include "main2.h"
 
 class BridgeWordsTest : public ::testing::Test {
@@ -21,11 +22,12 @@ protected:
         int them = table.getIndex("them");
         int more = table.getIndex("more");
 
-        graph.adjacencyMatrix[the][team] = 1;       // the -> team
-        graph.adjacencyMatrix[team][requested] = 1; // team -> requested
-        graph.adjacencyMatrix[the][them] = 1;       // the -> them
-        graph.adjacencyMatrix[them][requested] = 1; // them -> requested
-        graph.adjacencyMatrix[the][more] = 1;       // the -> more
+        graph.addEdge(the, team);        // the -> team
+        graph.addEdge(team, requested);  // team -> requested
+        graph.addEdge(the, them);        // the -> them
+        graph.addEdge(them, requested);  // them -> requested
+        graph.addEdge(the, more);        // the -> more
+        graph.finalize();
     }
 
     Graph graph{0}; // 初始化为0，在SetUp中重新初始化
@@ -101,6 +103,1180 @@ TEST_F(BridgeWordsTest, BothWordsNotExist) {
         << "Actual output: " << output;
 }
 
+// 测试用例6: 重复边合并为权重
+TEST(GraphTest, MergesDuplicateEdges) {
+    Graph graph(3);
+    graph.addEdge(0, 2);
+    graph.addEdge(0, 1);
+    graph.addEdge(0, 2);
+    graph.finalize();
+    graph.addEdge(0, 2);
+    graph.finalize();
+
+    EXPECT_EQ(graph.numEdges(), 2);
+    EXPECT_EQ(graph.outDegree(0), 2);
+    EXPECT_EQ(graph.edgeWeight(0, 1), 1);
+    EXPECT_EQ(graph.edgeWeight(0, 2), 3);
+    EXPECT_EQ(graph.edgeWeight(2, 0), 0);
+}
+
+// 测试用例7: 超过100个顶点的图
+TEST(GraphTest, MoreThanHundredVertices) {
+    WordTable table;
+    WordNode* head = nullptr;
+    WordNode* tail = nullptr;
+    for (int i = 0; i < 1000; i++) {
+        std::string word;
+        for (int n = i; ; n /= 26) {
+            word += char('a' + n % 26);
+            if (n < 26) break;
+        }
+        WordNode* node = new WordNode(word);
+        if (!head) head = tail = node; else tail = tail->next = node;
+    }
+
+    populateWordTable(head, table);
+    Graph graph(table.size());
+    buildGraph(head, graph, table);
+
+    EXPECT_EQ(table.size(), 1000u);
+    EXPECT_EQ(graph.numEdges(), 999);
+    EXPECT_EQ(graph.edgeWeight(table.getIndex("a"), table.getIndex("b")), 1);
+
+    while (head) {
+        WordNode* next = head->next;
+        delete head;
+        head = next;
+    }
+}
+
+// 测试用例8: 内存映射分词与旧流程结果一致
+TEST(TokenizerTest, MatchesLegacyPipeline) {
+    const std::string filename = "tokenizer_test.txt";
+    {
+        std::ofstream out(filename);
+        out << "The quick, brown FOX!\njumps over the lazy dog's "
+            << "abcdefghijklmnopqrstuvwxyz end";
+    }
+
+    WordTable table;
+    std::vector<int> tokens = tokenizeTextFile(filename, table);
+
+    std::vector<std::string> expected;
+    WordNode* head = sentenceToList(processTextFile(filename));
+    while (head) {
+        expected.push_back(head->word);
+        WordNode* next = head->next;
+        delete head;
+        head = next;
+    }
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(tokens.size(), expected.size());
+    for (size_t i = 0; i < tokens.size(); i++) {
+        EXPECT_EQ(table.word(tokens[i]), expected[i]);
+    }
+
+    Graph graph(table.size());
+    buildGraph(tokens, graph);
+    EXPECT_EQ(graph.edgeWeight(table.getIndex("the"), table.getIndex("quick")), 1);
+    EXPECT_EQ(graph.edgeWeight(table.getIndex("the"), table.getIndex("lazy")), 1);
+}
+
+// 测试用例9: 向量化字符分类与小写转换覆盖全部字节值
+TEST(TokenizerTest, LetterMaskAndLowercase) {
+    std::string bytes;
+    for (int round = 0; round < 3; round++) {
+        for (int c = 0; c < 256; c++) {
+            bytes += static_cast<char>((c * 37 + round) & 0xFF);
+        }
+    }
+
+    for (size_t base = 0; base + 32 <= bytes.size(); base += 7) {
+        uint32_t mask = letterMask32(bytes.data() + base);
+        for (int i = 0; i < 32; i++) {
+            EXPECT_EQ((mask >> i) & 1, isalpha(static_cast<unsigned char>(bytes[base + i])) ? 1u : 0u);
+        }
+    }
+
+    std::string lowered(bytes.size(), '\0');
+    lowerAscii(&lowered[0], bytes.data(), bytes.size());
+    for (size_t i = 0; i < bytes.size(); i++) {
+        char c = bytes[i];
+        EXPECT_EQ(lowered[i], (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c);
+    }
+}
+
+// 辅助函数：按编号顺序取出单词表
+std::vector<std::string> tableWords(const WordTable& table) {
+    std::vector<std::string> words;
+    for (size_t i = 0; i < table.size(); i++) {
+        words.emplace_back(table.word(i));
+    }
+    return words;
+}
+
+// 测试用例10: 多线程分块建图与顺序建图结果一致
+TEST(ParallelBuildTest, MatchesSequentialBuild) {
+    std::string text;
+    const char* words[] = {"Alpha", "beta", "gamma", "delta", "the", "a", "Supercalifragilisticexpialidocious"};
+    for (int i = 0; i < 500; i++) {
+        text += words[(i * 7 + i / 3) % 7];
+        text += (i % 5 == 0) ? ", " : " ";
+    }
+
+    WordTable expected_table;
+    std::vector<int> tokens;
+    forEachWord(text.data(), text.size(), [&](std::string_view word) {
+        tokens.push_back(expected_table.addWord(std::string(word)));
+    });
+    Graph expected(expected_table.size());
+    buildGraph(tokens, expected);
+
+    for (int threads = 1; threads <= 8; threads++) {
+        WordTable table;
+        Graph graph = buildGraphParallel(text.data(), text.size(), table, threads);
+        EXPECT_EQ(tableWords(table), tableWords(expected_table));
+        EXPECT_EQ(graph.rowOffsets, expected.rowOffsets);
+        EXPECT_EQ(graph.columnIndices, expected.columnIndices);
+        EXPECT_EQ(graph.edgeWeights, expected.edgeWeights);
+    }
+}
+
+// 测试用例11: 流式建图按任意字节块输入结果不变
+TEST(GraphBuilderTest, ChunkedTextMatchesWholeText) {
+    std::string text = "It was the best of times, it was the worst of times; "
+                       "it was the age of wisdom... Incomprehensibilities abound!";
+
+    WordTable whole_table;
+    GraphBuilder whole_builder(whole_table);
+    whole_builder.addText(text.data(), text.size());
+    Graph whole = whole_builder.finish();
+
+    for (size_t step = 1; step <= 9; step++) {
+        WordTable table;
+        GraphBuilder builder(table);
+        for (size_t pos = 0; pos < text.size(); pos += step) {
+            builder.addText(text.data() + pos, std::min(step, text.size() - pos));
+        }
+        Graph graph = builder.finish();
+        EXPECT_EQ(tableWords(table), tableWords(whole_table));
+        EXPECT_EQ(graph.columnIndices, whole.columnIndices);
+        EXPECT_EQ(graph.edgeWeights, whole.edgeWeights);
+    }
+
+    EXPECT_EQ(whole.edgeWeight(whole_table.getIndex("it"), whole_table.getIndex("was")), 3);
+    EXPECT_NE(whole_table.getIndex("incomprehensibiliti"), -1);
+}
+
+// 测试用例12: 单词池扩容与超长单词
+TEST(WordTableTest, InternsManyWords) {
+    WordTable table;
+    std::string long_word(100000, 'x');
+    for (int i = 0; i < 20000; i++) {
+        EXPECT_EQ(table.addWord("w" + std::to_string(i)), i + (i > 5000));
+        if (i == 5000) {
+            EXPECT_EQ(table.addWord(long_word), 5001);
+        }
+    }
+    EXPECT_EQ(table.addWord(""), 20001);
+
+    EXPECT_EQ(table.size(), 20002u);
+    EXPECT_EQ(table.addWord("w123"), 123);
+    EXPECT_EQ(table.getIndex("w19999"), 20000);
+    EXPECT_EQ(table.getIndex("w5001"), 5002);
+    EXPECT_EQ(table.getIndex(long_word), 5001);
+    EXPECT_EQ(table.getIndex(""), 20001);
+    EXPECT_EQ(table.getIndex("w20000"), -1);
+    EXPECT_EQ(table.word(5001), long_word);
+    EXPECT_EQ(table.word(20000), "w19999");
+}
+
+// 测试用例13: 按字符区间与预计算哈希查找
+TEST(WordTableTest, LooksUpCharacterRanges) {
+    WordTable table;
+    table.addWord("bridge");
+    table.addWord("word");
+
+    const char text[] = "a bridge word";
+    std::string_view bridge(text + 2, 6);
+    std::string_view word(text + 9, 4);
+    EXPECT_EQ(table.getIndex(bridge), 0);
+    EXPECT_EQ(table.getIndex(word, WordTable::hash(word)), 1);
+    EXPECT_EQ(table.getIndex(std::string_view(text, 1)), -1);
+    EXPECT_EQ(table.addWord(std::string_view(text + 9, 4)), 1);
+}
+
+// 测试用例14: 冻结后的完美哈希查找
+TEST(WordTableTest, FrozenLookups) {
+    WordTable table;
+    for (int i = 0; i < 5000; i++) {
+        table.addWord("word" + std::to_string(i));
+    }
+
+    ASSERT_TRUE(table.freeze());
+    EXPECT_TRUE(table.isFrozen());
+    for (int i = 0; i < 5000; i++) {
+        EXPECT_EQ(table.getIndex("word" + std::to_string(i)), i);
+    }
+    EXPECT_EQ(table.getIndex("word5000"), -1);
+    EXPECT_EQ(table.getIndex("missing"), -1);
+
+    EXPECT_EQ(table.addWord("word42"), 42);
+    EXPECT_FALSE(table.isFrozen());
+    EXPECT_EQ(table.addWord("word5000"), 5000);
+    EXPECT_EQ(table.getIndex("word4999"), 4999);
+
+    WordTable empty;
+    EXPECT_TRUE(empty.freeze());
+    EXPECT_EQ(empty.getIndex("word"), -1);
+}
+
+// 测试用例15: 堆优化 Dijkstra 与提前终止
+TEST(ShortestPathTest, HeapDijkstra) {
+    Graph graph(5);
+    graph.addEdge(0, 1, 4);
+    graph.addEdge(0, 2, 1);
+    graph.addEdge(2, 1, 2);
+    graph.addEdge(1, 3, 1);
+    graph.addEdge(3, 4, 5);
+    graph.finalize();
+
+    std::vector<int> dist, prev;
+    dijkstra(graph, 0, dist, prev);
+    EXPECT_EQ(dist, (std::vector<int>{0, 3, 1, 4, 9}));
+    EXPECT_EQ(prev, (std::vector<int>{-1, 2, 0, 1, 3}));
+
+    dijkstra(graph, 0, dist, prev, 1);
+    EXPECT_EQ(dist[1], 3);
+    EXPECT_EQ(dist[4], INT_MAX);
+}
+
+// 测试用例16: 动态规划计数最短路径并按需枚举
+TEST(ShortestPathTest, CountsAndEnumeratesDag) {
+    // 源点 -> 4 层、每层 8 个顶点的完全二分层 -> 终点，共 8^4 条最短路
+    const int layers = 4, width = 8;
+    int target = 1 + layers * width;
+    Graph graph(target + 1);
+    for (int v = 0; v < width; v++) {
+        graph.addEdge(0, 1 + v);
+        graph.addEdge(1 + (layers - 1) * width + v, target);
+    }
+    for (int l = 0; l + 1 < layers; l++) {
+        for (int a = 0; a < width; a++) {
+            for (int b = 0; b < width; b++) {
+                graph.addEdge(1 + l * width + a, 1 + (l + 1) * width + b);
+            }
+        }
+    }
+    graph.addEdge(0, target, 6);  // 更长的捷径不计入
+    graph.finalize();
+
+    std::vector<int> dist, prev;
+    dijkstra(graph, 0, dist, prev, target);
+    ShortestPathDag dag(graph, 0, target, dist);
+    EXPECT_EQ(dag.distance(), layers + 1);
+    EXPECT_EQ(dag.pathCount(), 4096u);
+
+    std::vector<int> path;
+    std::vector<std::vector<int>> seen;
+    while (dag.nextPath(path)) {
+        ASSERT_EQ(path.size(), static_cast<size_t>(layers + 2));
+        seen.push_back(path);
+    }
+    EXPECT_EQ(seen.size(), 4096u);
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+    EXPECT_TRUE(std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+
+    PathList limited = findAllShortestPaths(graph, 0, target, dist);
+    EXPECT_EQ(limited.paths.size(), static_cast<size_t>(MAX_PATHS));
+    EXPECT_EQ(limited.total_paths, 4096u);
+}
+
+// 测试用例17: 双向 Dijkstra 与单向结果一致
+TEST(ShortestPathTest, BidirectionalMatchesDijkstra) {
+    std::mt19937 gen(2024);
+    for (int round = 0; round < 20; round++) {
+        int n = 30;
+        Graph graph(n);
+        for (int k = 0; k < 90; k++) {
+            graph.addEdge(gen() % n, gen() % n, 1 + gen() % 3);
+        }
+        graph.finalize();
+        ASSERT_EQ(graph.inSources.size(), graph.columnIndices.size());
+
+        for (int s = 0; s < n; s++) {
+            for (int t = 0; t < n; t++) {
+                std::vector<int> dist, prev, bidist;
+                dijkstra(graph, s, dist, prev, t);
+                int distance = bidirectionalDijkstra(graph, s, t, bidist);
+                ASSERT_EQ(distance, dist[t]);
+                if (distance == INT_MAX) continue;
+
+                ShortestPathDag expected(graph, s, t, dist);
+                ShortestPathDag actual(graph, s, t, bidist);
+                ASSERT_EQ(actual.pathCount(), expected.pathCount());
+                std::vector<int> a, b;
+                while (expected.nextPath(a)) {
+                    ASSERT_TRUE(actual.nextPath(b));
+                    ASSERT_EQ(a, b);
+                }
+                EXPECT_FALSE(actual.nextPath(b));
+            }
+        }
+    }
+}
+
+// 测试用例18: 地标 A* 查询与 Dijkstra 一致
+TEST(ShortestPathTest, LandmarkQueriesMatchDijkstra) {
+    std::mt19937 gen(7);
+    for (int round = 0; round < 10; round++) {
+        int n = 40;
+        Graph graph(n);
+        for (int k = 0; k < 100; k++) {
+            graph.addEdge(gen() % n, gen() % n, 1 + gen() % 4);
+        }
+        graph.finalize();
+        LandmarkIndex index(graph, 4);
+        EXPECT_EQ(index.landmarks().size(), 4u);
+
+        for (int s = 0; s < n; s++) {
+            std::vector<int> dist, prev;
+            dijkstra(graph, s, dist, prev);
+            for (int t = 0; t < n; t++) {
+                ASSERT_LE(index.lowerBound(s, t), dist[t]);
+                std::vector<int> labels;
+                ASSERT_EQ(index.query(s, t, labels), dist[t]);
+                if (dist[t] == INT_MAX) continue;
+                ShortestPathDag expected(graph, s, t, dist);
+                ShortestPathDag actual(graph, s, t, labels);
+                ASSERT_EQ(actual.pathCount(), expected.pathCount());
+            }
+        }
+    }
+}
+
+// 测试用例19: 收缩层次查询与 Dijkstra 一致，保存后重新加载结果不变
+TEST(ShortestPathTest, ContractionHierarchyMatchesDijkstra) {
+    std::mt19937 gen(11);
+    for (int round = 0; round < 10; round++) {
+        int n = 40;
+        Graph graph(n);
+        for (int k = 0; k < 100; k++) {
+            graph.addEdge(gen() % n, gen() % n, 1 + gen() % 4);
+        }
+        graph.finalize();
+        ContractionHierarchy built(graph);
+        ASSERT_TRUE(built.save("test_ch.bin"));
+        ContractionHierarchy hierarchy;
+        ASSERT_TRUE(hierarchy.load("test_ch.bin", graph));
+        EXPECT_EQ(hierarchy.numVertices(), n);
+        EXPECT_EQ(hierarchy.numShortcuts(), built.numShortcuts());
+
+        for (int s = 0; s < n; s++) {
+            std::vector<int> dist, prev;
+            dijkstra(graph, s, dist, prev);
+            for (int t = 0; t < n; t++) {
+                std::vector<int> path;
+                ASSERT_EQ(hierarchy.query(s, t, path), dist[t]);
+                if (dist[t] == INT_MAX) {
+                    EXPECT_TRUE(path.empty());
+                    continue;
+                }
+                ASSERT_EQ(path.front(), s);
+                ASSERT_EQ(path.back(), t);
+                int length = 0;
+                for (size_t i = 1; i < path.size(); i++) {
+                    ASSERT_GT(graph.edgeWeight(path[i - 1], path[i]), 0);
+                    length += graph.edgeWeight(path[i - 1], path[i]);
+                }
+                EXPECT_EQ(length, dist[t]);
+            }
+        }
+    }
+    std::remove("test_ch.bin");
+}
+
+// 测试用例20: 全源距离矩阵（逐源 Dijkstra 与分块 Floyd-Warshall）与 Dijkstra 一致
+TEST(ShortestPathTest, DistanceMatrixMatchesDijkstra) {
+    std::mt19937 gen(13);
+    int n = 150;
+    Graph graph(n);
+    for (int k = 0; k < 600; k++) {
+        graph.addEdge(gen() % n, gen() % n, 1 + gen() % 4);
+    }
+    graph.finalize();
+    DistanceMatrix by_dijkstra(graph, DistanceMatrix::Method::PerSourceDijkstra, 3);
+    DistanceMatrix by_floyd(graph, DistanceMatrix::Method::BlockedFloydWarshall, 3);
+
+    for (int s = 0; s < n; s++) {
+        std::vector<int> dist, prev;
+        dijkstra(graph, s, dist, prev);
+        for (int t = 0; t < n; t++) {
+            ASSERT_EQ(by_dijkstra.distance(s, t), dist[t]);
+            ASSERT_EQ(by_floyd.distance(s, t), dist[t]);
+            std::vector<int> path;
+            ASSERT_EQ(by_floyd.shortestPath(s, t, path), dist[t] != INT_MAX);
+            if (dist[t] == INT_MAX) continue;
+            ASSERT_EQ(path.front(), s);
+            ASSERT_EQ(path.back(), t);
+            int length = 0;
+            for (size_t i = 1; i < path.size(); i++) {
+                length += graph.edgeWeight(path[i - 1], path[i]);
+            }
+            EXPECT_EQ(length, dist[t]);
+        }
+    }
+
+    // 超出 16 位范围的距离被截断为 SATURATED，不可达仍然是 INT_MAX
+    Graph heavy(3);
+    heavy.addEdge(0, 1, 40000);
+    heavy.addEdge(1, 2, 40000);
+    heavy.finalize();
+    DistanceMatrix clamped(heavy, DistanceMatrix::Method::BlockedFloydWarshall);
+    EXPECT_EQ(clamped.distance(0, 1), 40000);
+    EXPECT_EQ(clamped.distance(0, 2), DistanceMatrix::SATURATED);
+    EXPECT_EQ(clamped.distance(2, 0), INT_MAX);
+}
+
+// 测试用例21: 并行 delta-stepping 与 Dijkstra 的距离和前驱完全一致
+TEST(ShortestPathTest, DeltaSteppingMatchesDijkstra) {
+    std::mt19937 gen(17);
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    for (int round = 0; round < 5; round++) {
+        int n = 2000;
+        Graph graph(n);
+        for (int k = 0; k < 8000; k++) {
+            graph.addEdge(gen() % n, gen() % n, 1 + gen() % 5);
+        }
+        graph.finalize();
+
+        for (int delta : {0, 1, 3, 100}) {
+            int s = gen() % n;
+            std::vector<int> expected, expected_prev;
+            dijkstra(graph, s, expected, expected_prev);
+            std::vector<int> dist, prev;
+            deltaStepping(graph, s, dist, prev, pool, delta);
+            ASSERT_EQ(dist, expected);
+            ASSERT_EQ(prev, expected_prev);
+        }
+    }
+}
+
+// 测试用例22: Yen 算法返回的前 K 条简单路径与穷举结果的长度一致
+TEST(ShortestPathTest, YenKShortestSimplePaths) {
+    std::mt19937 gen(19);
+    for (int round = 0; round < 20; round++) {
+        int n = 8;
+        Graph graph(n);
+        for (int k = 0; k < 24; k++) {
+            graph.addEdge(gen() % n, gen() % n, 1 + gen() % 4);
+        }
+        graph.finalize();
+        int s = 0, t = n - 1;
+
+        // 深度优先穷举所有简单路径的长度
+        std::vector<int> all_weights;
+        std::vector<int> stack(1, s);
+        std::vector<bool> on_path(n, false);
+        on_path[s] = true;
+        std::function<void(int)> walk = [&](int weight) {
+            int u = stack.back();
+            if (u == t) {
+                all_weights.push_back(weight);
+                return;
+            }
+            for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+                int v = graph.columnIndices[e];
+                if (on_path[v]) continue;
+                on_path[v] = true;
+                stack.push_back(v);
+                walk(weight + graph.edgeWeights[e]);
+                stack.pop_back();
+                on_path[v] = false;
+            }
+        };
+        walk(0);
+        std::sort(all_weights.begin(), all_weights.end());
+
+        PathList result = kShortestPaths(graph, s, t, 6);
+        size_t expected = std::min<size_t>(6, all_weights.size());
+        ASSERT_EQ(result.paths.size(), expected);
+        std::set<std::vector<int>> distinct;
+        for (size_t i = 0; i < result.paths.size(); i++) {
+            const std::vector<int>& path = result.paths[i];
+            EXPECT_EQ(result.path_weights[i], all_weights[i]);
+            EXPECT_EQ(path.front(), s);
+            EXPECT_EQ(path.back(), t);
+            EXPECT_EQ(std::set<int>(path.begin(), path.end()).size(), path.size());
+            int weight = 0;
+            for (size_t j = 1; j < path.size(); j++) {
+                ASSERT_GT(graph.edgeWeight(path[j - 1], path[j]), 0);
+                weight += graph.edgeWeight(path[j - 1], path[j]);
+            }
+            EXPECT_EQ(weight, result.path_weights[i]);
+            distinct.insert(path);
+        }
+        EXPECT_EQ(distinct.size(), result.paths.size());
+    }
+}
+
+// 测试用例23: 同一个查询上下文在多次查询、不同大小的图之间复用，结果与全新计算一致
+TEST(ShortestPathTest, ReusedWorkspaceMatchesFreshSearch) {
+    std::mt19937 gen(23);
+    SearchWorkspace workspace;
+    QueryContext context;
+    for (int round = 0; round < 6; round++) {
+        int n = 30 + 20 * (round % 3);
+        Graph graph(n);
+        for (int k = 0; k < 4 * n; k++) {
+            graph.addEdge(gen() % n, gen() % n, 1 + gen() % 4);
+        }
+        graph.finalize();
+        LandmarkIndex index(graph, 3);
+        ContractionHierarchy hierarchy(graph);
+
+        for (int q = 0; q < 50; q++) {
+            int s = gen() % n, t = gen() % n;
+            std::vector<int> dist, prev;
+            dijkstra(graph, s, dist, prev);
+            ASSERT_EQ(dijkstra(graph, s, t, workspace), dist[t]);
+            dijkstra(graph, s, -1, workspace);
+            for (int v = 0; v < n; v++) {
+                ASSERT_EQ(workspace.distance(v), dist[v]);
+                ASSERT_EQ(workspace.parent(v), prev[v]);
+            }
+            ASSERT_EQ(bidirectionalDijkstra(graph, s, t, context), dist[t]);
+            ASSERT_EQ(index.query(s, t, context.forward), dist[t]);
+            std::vector<int> path;
+            ASSERT_EQ(hierarchy.query(s, t, path, context), dist[t]);
+        }
+    }
+}
+
+// 测试用例24: 拉取式 PageRank 与按出边推送的朴素实现一致
+TEST(PageRankTest, PullKernelMatchesPushReference) {
+    std::mt19937 gen(29);
+    int n = 300;
+    Graph graph(n);
+    for (int k = 0; k < 1500; k++) {
+        int u = gen() % n;
+        if (u % 10 == 0) continue;  // 留下一些悬挂节点
+        graph.addEdge(u, gen() % n, 1 + gen() % 3);
+    }
+    graph.finalize();
+    PageRankEngine engine(graph);
+    EXPECT_FALSE(engine.danglingVertices().empty());
+
+    std::vector<double> rank(n, 1.0 / n), next;
+    for (int iter = 0; iter < 5; iter++) {
+        // 朴素实现：逐条出边推送，每条边做一次除法
+        std::vector<double> expected(n, (1.0 - DAMPING_FACTOR) / n);
+        double dangling = 0.0;
+        for (int u = 0; u < n; u++) {
+            int out_weight = 0;
+            for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+                out_weight += graph.edgeWeights[e];
+            }
+            if (out_weight == 0) {
+                dangling += rank[u];
+                continue;
+            }
+            for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+                expected[graph.columnIndices[e]] += DAMPING_FACTOR * rank[u] * graph.edgeWeights[e] / out_weight;
+            }
+        }
+        engine.step(rank, next, DAMPING_FACTOR);
+        double total = 0.0;
+        for (int v = 0; v < n; v++) {
+            ASSERT_NEAR(next[v], expected[v] + DAMPING_FACTOR * dangling / n, 1e-12);
+            total += next[v];
+        }
+        EXPECT_NEAR(total, 1.0, 1e-9);
+        rank.swap(next);
+    }
+
+    std::vector<double> converged(n, 1.0 / n);
+    int iterations = engine.run(converged);
+    EXPECT_LT(iterations, MAX_ITERATIONS);
+    EXPECT_LT(engine.step(converged, next, DAMPING_FACTOR), TOLERANCE);
+}
+
+// 测试用例25: 多线程 PageRank 与单线程结果逐位一致
+TEST(PageRankTest, ParallelRanksAreBitIdentical) {
+    std::mt19937 gen(31);
+    int n = 10000;
+    Graph graph(n);
+    for (int k = 0; k < 60000; k++) {
+        graph.addEdge(gen() % n, gen() % n, 1 + gen() % 3);
+    }
+    graph.finalize();
+
+    PageRankEngine serial(graph);
+    std::vector<double> expected(n, 1.0 / n);
+    int expected_iterations = serial.run(expected);
+
+    for (int threads : {2, 3, 8}) {
+        ThreadPool pool(threads);
+        PageRankEngine parallel(graph, &pool);
+        std::vector<double> rank(n, 1.0 / n);
+        EXPECT_EQ(parallel.run(rank), expected_iterations);
+        ASSERT_EQ(rank, expected);
+    }
+}
+
+// 测试用例26: 个性化 PageRank 的幂迭代与前向推送近似结果一致
+TEST(PageRankTest, PersonalizedPageRankAndForwardPush) {
+    std::mt19937 gen(37);
+    int n = 400;
+    Graph graph(n);
+    for (int k = 0; k < 1600; k++) {
+        int u = gen() % n;
+        if (u % 15 == 0) continue;
+        graph.addEdge(u, gen() % n, 1 + gen() % 3);
+    }
+    graph.finalize();
+    PageRankEngine engine(graph);
+    std::vector<int> seeds = {3, 42, 42, 100};
+
+    std::vector<double> exact = personalizedPageRank(engine, seeds);
+    double total = 0.0;
+    for (double r : exact) total += r;
+    EXPECT_NEAR(total, 1.0, 1e-9);
+    EXPECT_GT(exact[42], exact[3]);
+
+    std::vector<std::pair<int, double>> approx = approximatePersonalizedPageRank(graph, seeds, DAMPING_FACTOR, 1e-8);
+    ASSERT_FALSE(approx.empty());
+    for (size_t i = 1; i < approx.size(); i++) {
+        EXPECT_GE(approx[i - 1].second, approx[i].second);
+    }
+    std::vector<double> dense(n, 0.0);
+    for (const auto& entry : approx) dense[entry.first] = entry.second;
+    double l1 = 0.0;
+    for (int v = 0; v < n; v++) l1 += std::fabs(dense[v] - exact[v]);
+    EXPECT_LT(l1, 1e-4);
+
+    // 阈值较大时只访问种子附近的少数节点
+    std::vector<std::pair<int, double>> coarse = approximatePersonalizedPageRank(graph, {7}, DAMPING_FACTOR, 1e-2);
+    EXPECT_LT(coarse.size(), 50u);
+    EXPECT_EQ(coarse[0].first, 7);
+}
+
+// 测试用例27: 追加文本后增量更新的 PageRank 与从头计算一致
+TEST(PageRankTest, IncrementalUpdateAfterAppend) {
+    std::mt19937 gen(41);
+    std::vector<int> tokens;
+    for (int i = 0; i < 20000; i++) {
+        tokens.push_back(gen() % (i < 19900 ? 2000 : 2010));
+    }
+    std::vector<int> prefix(tokens.begin(), tokens.begin() + 19900);
+    Graph before(2000), after(2010);
+    buildGraph(prefix, before);
+    buildGraph(tokens, after);
+
+    PageRankEngine old_engine(before);
+    std::vector<double> rank(2000, 1.0 / 2000);
+    old_engine.run(rank, DAMPING_FACTOR, 200, 1e-12);
+
+    int pushes = updatePageRank(before, after, rank, DAMPING_FACTOR, 1e-9);
+    EXPECT_GT(pushes, 0);
+
+    PageRankEngine new_engine(after);
+    std::vector<double> expected(2010, 1.0 / 2010);
+    new_engine.run(expected, DAMPING_FACTOR, 200, 1e-12);
+    ASSERT_EQ(rank.size(), expected.size());
+    double l1 = 0.0;
+    for (size_t v = 0; v < rank.size(); v++) l1 += std::fabs(rank[v] - expected[v]);
+    EXPECT_LT(l1, 1e-7);
+}
+
+// 测试用例28: 不同求解方法收敛到同一结果，Gauss-Seidel 迭代次数更少
+TEST(PageRankTest, SolverMethodsAgree) {
+    std::mt19937 gen(7);
+    std::vector<int> tokens;
+    for (int i = 0; i < 30000; i++) {
+        tokens.push_back((i % 300 + (gen() % 7 == 0 ? gen() % 300 : 0)) % 300);
+    }
+    Graph graph(300);
+    buildGraph(tokens, graph);
+    PageRankEngine engine(graph);
+
+    PageRankOptions options;
+    options.damping = 0.95;
+    options.max_iterations = 1000;
+    options.tolerance = 1e-13;
+    std::vector<double> expected(300, 1.0 / 300);
+    ASSERT_TRUE(engine.solve(expected, options).converged);
+
+    options.tolerance = 1e-8;
+    std::vector<int> iterations;
+    for (PageRankOptions::Method method : {PageRankOptions::Method::Jacobi, PageRankOptions::Method::GaussSeidel,
+                                           PageRankOptions::Method::Aitken, PageRankOptions::Method::Quadratic}) {
+        options.method = method;
+        std::vector<double> rank(300, 1.0 / 300);
+        PageRankStats stats = engine.solve(rank, options);
+        EXPECT_TRUE(stats.converged);
+        EXPECT_EQ(static_cast<int>(stats.residuals.size()), stats.iterations + 1);
+        EXPECT_LT(stats.residuals.back(), options.tolerance);
+        double l1 = 0.0, sum = 0.0;
+        for (int v = 0; v < 300; v++) {
+            l1 += std::fabs(rank[v] - expected[v]);
+            sum += rank[v];
+        }
+        EXPECT_LT(l1, 1e-7);
+        EXPECT_NEAR(sum, 1.0, 1e-12);
+        iterations.push_back(stats.iterations);
+    }
+    EXPECT_LT(iterations[1], iterations[0]);
+    EXPECT_LE(iterations[3], iterations[0]);
+}
+
+// 测试用例29: 结构化 PageRank 结果的 top-K 与打印
+TEST(PageRankTest, TopKResultAndPrinter) {
+    WordTable table;
+    std::vector<int> tokens;
+    std::mt19937 gen(3);
+    for (int i = 0; i < 50; i++) {
+        table.addWord("w" + std::to_string(i));
+    }
+    for (int i = 0; i < 2000; i++) {
+        tokens.push_back(gen() % (gen() % 2 ? 5 : 50));
+    }
+    Graph graph(50);
+    buildGraph(tokens, graph);
+
+    PageRankResult result = computePageRank(graph, PageRankOptions(), 5);
+    ASSERT_EQ(result.ranks.size(), 50u);
+    ASSERT_EQ(result.top.size(), 5u);
+    EXPECT_TRUE(result.stats.converged);
+    std::vector<double> sorted = result.ranks;
+    std::sort(sorted.rbegin(), sorted.rend());
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(result.top[i].second, sorted[i]);
+        EXPECT_EQ(result.ranks[result.top[i].first], sorted[i]);
+    }
+    EXPECT_EQ(topRanked(result.ranks, 100).size(), 50u);
+
+    std::ostringstream out;
+    printPageRank(result, table, out);
+    std::string text = out.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 6);
+    EXPECT_NE(text.find(std::string(table.word(result.top[0].first)) + ": "), std::string::npos);
+
+    result.top.clear();
+    std::ostringstream all;
+    printPageRank(result, table, all);
+    text = all.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 51);
+}
+
+// 测试用例30: 蒙特卡洛 PageRank 估计接近精确值且与线程数无关
+TEST(PageRankTest, MonteCarloEstimate) {
+    std::mt19937 gen(5);
+    std::vector<int> tokens;
+    for (int i = 0; i < 3000; i++) {
+        tokens.push_back(gen() % (gen() % 3 ? 60 : 8));
+    }
+    tokens.push_back(60);  // ends on a dangling word
+    Graph graph(61);
+    buildGraph(tokens, graph);
+
+    PageRankOptions options;
+    options.tolerance = 1e-12;
+    PageRankResult exact = computePageRank(graph, options, 1);
+
+    MonteCarloPageRank serial = monteCarloPageRank(graph, 400, DAMPING_FACTOR, 9);
+    ThreadPool pool(3);
+    MonteCarloPageRank parallel = monteCarloPageRank(graph, 400, DAMPING_FACTOR, 9, &pool);
+    EXPECT_EQ(serial.ranks, parallel.ranks);
+    EXPECT_EQ(serial.steps, parallel.steps);
+    EXPECT_GT(serial.steps, 0);
+
+    double l1 = 0.0, sum = 0.0;
+    int covered = 0;
+    for (int v = 0; v < 61; v++) {
+        double error = std::fabs(serial.ranks[v] - exact.ranks[v]);
+        l1 += error;
+        sum += serial.ranks[v];
+        covered += error <= serial.half_width[v];
+    }
+    EXPECT_NEAR(sum, 1.0, 1e-9);
+    EXPECT_LT(l1, 0.03);
+    EXPECT_GT(covered, 61 * 3 / 4);
+    EXPECT_EQ(topRanked(serial.ranks, 1)[0].first, exact.top[0].first);
+}
+
+// 测试用例31: 桥接词索引与逐个查边的结果一致
+TEST(BridgeWordIndexTest, MatchesEdgeLookups) {
+    std::mt19937 gen(17);
+    std::vector<int> tokens;
+    for (int i = 0; i < 20000; i++) {
+        tokens.push_back(gen() % 4 == 0 ? gen() % 6 : gen() % 4000);  // a few hubs among sparse words
+    }
+    Graph graph(4000);
+    buildGraph(tokens, graph);
+    BridgeWordIndex index(graph);
+
+    std::vector<int> ids;
+    for (int id = 0; id < 4000; id += id < 8 ? 1 : 37) {
+        ids.push_back(id);
+    }
+    std::vector<int> bridges, indexed;
+    for (int id1 : ids) {
+        for (int id2 : ids) {
+            std::vector<int> expected;
+            for (int e = graph.rowOffsets[id1]; e < graph.rowOffsets[id1 + 1]; e++) {
+                if (graph.edgeIndex(graph.columnIndices[e], id2) != -1) {
+                    expected.push_back(graph.columnIndices[e]);
+                }
+            }
+            bridgeWords(graph, id1, id2, bridges);
+            index.find(id1, id2, indexed);
+            EXPECT_EQ(bridges, expected);
+            EXPECT_EQ(indexed, expected);
+        }
+    }
+    index.find(0, 1, indexed);
+    EXPECT_FALSE(indexed.empty());
+}
+
+// 测试用例32: 多个线程共用同一个线程池时依次执行，结果正确且不会死锁
+TEST(ThreadPoolTest, ConcurrentCallersShareOnePool) {
+    std::mt19937 gen(23);
+    int n = 3000;
+    Graph graph(n);
+    for (int k = 0; k < 12000; k++) {
+        graph.addEdge(gen() % n, gen() % n, 1 + gen() % 5);
+    }
+    graph.finalize();
+    std::vector<int> expected, expected_prev;
+    dijkstra(graph, 0, expected, expected_prev);
+
+    ThreadPool pool(4);
+    std::atomic<int> mismatches(0);
+    auto caller = [&] {
+        for (int i = 0; i < 20; i++) {
+            std::vector<int> dist, prev;
+            deltaStepping(graph, 0, dist, prev, pool);
+            if (dist != expected || prev != expected_prev) mismatches++;
+        }
+    };
+    std::thread first(caller), second(caller);
+    first.join();
+    second.join();
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+// 测试用例33: 两个线程通过同一个线程池同时计算 PageRank，结果一致
+TEST(PageRankTest, ConcurrentCallersShareOnePool) {
+    std::mt19937 gen(29);
+    std::vector<int> tokens;
+    for (int i = 0; i < 40000; i++) {
+        tokens.push_back(gen() % 6000);
+    }
+    Graph graph(6000);
+    buildGraph(tokens, graph);
+    PageRankResult expected = computePageRank(graph);
+
+    ThreadPool pool(4);
+    std::atomic<int> mismatches(0);
+    auto caller = [&] {
+        for (int i = 0; i < 10; i++) {
+            if (computePageRank(graph, PageRankOptions(), 0, &pool).ranks != expected.ranks) mismatches++;
+        }
+    };
+    std::thread first(caller), second(caller);
+    first.join();
+    second.join();
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+// 测试用例34: 损坏或过期的收缩层次文件被拒绝而不是抛异常或越界
+TEST(ShortestPathTest, ContractionHierarchyRejectsBadFiles) {
+    std::mt19937 gen(31);
+    int n = 30;
+    Graph graph(n);
+    for (int k = 0; k < 90; k++) {
+        graph.addEdge(gen() % n, gen() % n, 1 + gen() % 4);
+    }
+    graph.finalize();
+    ASSERT_TRUE(ContractionHierarchy(graph).save("test_ch.bin"));
+    std::ifstream in("test_ch.bin", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    auto load_bytes = [&](const std::string& data, const Graph& g) {
+        std::ofstream out("test_ch.bin", std::ios::binary);
+        out.write(data.data(), data.size());
+        out.close();
+        // 先建好层次，被拒绝的文件必须把旧数据清空
+        ContractionHierarchy hierarchy(graph);
+        bool ok = hierarchy.load("test_ch.bin", g);
+        if (!ok) {
+            EXPECT_EQ(hierarchy.numVertices(), 0);
+            std::vector<int> path;
+            EXPECT_EQ(hierarchy.query(0, 1, path), INT_MAX);
+            EXPECT_TRUE(path.empty());
+        }
+        return ok;
+    };
+    EXPECT_TRUE(load_bytes(bytes, graph));
+    EXPECT_FALSE(load_bytes("WGCH9999" + bytes.substr(8), graph));
+    EXPECT_FALSE(load_bytes(bytes.substr(0, 12), graph));
+
+    ContractionHierarchy missing(graph);
+    EXPECT_FALSE(missing.load("no_such_ch.bin", graph));
+    EXPECT_EQ(missing.numVertices(), 0);
+
+    // Header is magic, vertex count, edge count and checksum; arrays follow
+    size_t rank_count = 8 + 3 * sizeof(uint64_t);
+    std::string huge = bytes;
+    uint64_t count = uint64_t(1) << 61;
+    huge.replace(rank_count, sizeof(count), reinterpret_cast<const char*>(&count), sizeof(count));
+    EXPECT_FALSE(load_bytes(huge, graph));
+    EXPECT_FALSE(load_bytes(bytes.substr(0, bytes.size() - 4), graph));
+
+    size_t up_targets = rank_count + 8 + n * sizeof(int) + 8 + (n + 1) * sizeof(int) + 8;
+    std::string bad_target = bytes;
+    int out_of_range = n + 5;
+    bad_target.replace(up_targets, sizeof(int), reinterpret_cast<const char*>(&out_of_range), sizeof(int));
+    EXPECT_FALSE(load_bytes(bad_target, graph));
+
+    std::string bad_offset = bytes;
+    int offset = 1000;
+    bad_offset.replace(up_targets - 8 - sizeof(int), sizeof(int), reinterpret_cast<const char*>(&offset),
+                       sizeof(int));
+    EXPECT_FALSE(load_bytes(bad_offset, graph));
+
+    // Rebuilt graph with one more edge: the saved index is stale
+    Graph rebuilt(n);
+    for (int u = 0; u < n; u++) {
+        for (int e = graph.rowOffsets[u]; e < graph.rowOffsets[u + 1]; e++) {
+            rebuilt.addEdge(u, graph.columnIndices[e], graph.edgeWeights[e]);
+        }
+    }
+    rebuilt.addEdge(0, 1, 7);
+    rebuilt.finalize();
+    EXPECT_FALSE(load_bytes(bytes, rebuilt));
+    std::remove("test_ch.bin");
+}
+
+// 测试用例35: 距离矩阵中被截断的距离回退到 Dijkstra，仍能输出正确路径
+TEST(ShortestPathTest, DistanceMatrixFallsBackOnSaturatedEntries) {
+    WordTable table;
+    table.addWord("a");
+    table.addWord("b");
+    table.addWord("c");
+    Graph heavy(3);
+    heavy.addEdge(0, 1, 40000);
+    heavy.addEdge(1, 2, 40000);
+    heavy.finalize();
+    DistanceMatrix matrix(heavy);
+    ASSERT_EQ(matrix.distance(0, 2), DistanceMatrix::SATURATED);
+
+    testing::internal::CaptureStdout();
+    showShortestPath(heavy, table, matrix, "a", "c");
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("(length 80000)"), std::string::npos) << output;
+    EXPECT_NE(output.find("a -> b -> c"), std::string::npos) << output;
+
+    testing::internal::CaptureStdout();
+    showShortestPath(heavy, table, matrix, "a");
+    output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Shortest path from a to c (length 80000)"), std::string::npos) << output;
+    EXPECT_EQ(output.find("No path from a to c"), std::string::npos) << output;
+}
+
+// 测试用例36: 复用查询上下文与工作区，结果与每次新建时一致
+TEST(ShortestPathTest, ReusedContextsMatchFreshSearches) {
+    std::mt19937 gen(99);
+    QueryContext context;
+    DeltaSteppingWorkspace workspace;
+    ThreadPool pool(3);
+    for (int round = 0; round < 10; round++) {
+        int n = 20 + round * 3;
+        Graph graph(n);
+        for (int k = 0; k < 3 * n; k++) {
+            graph.addEdge(gen() % n, gen() % n, 1 + gen() % 5);
+        }
+        graph.finalize();
+
+        for (int s = 0; s < n; s++) {
+            std::vector<int> dist, prev, delta_dist, delta_prev;
+            dijkstra(graph, s, dist, prev);
+            deltaStepping(graph, s, delta_dist, delta_prev, pool, workspace);
+            ASSERT_EQ(delta_dist, dist);
+            ASSERT_EQ(delta_prev, prev);
+
+            for (int t = 0; t < n; t++) {
+                int distance = bidirectionalDijkstra(graph, s, t, context);
+                ASSERT_EQ(distance, dist[t]);
+                ShortestPathDag expected(graph, s, t, dist);
+                ShortestPathDag actual(graph, s, t, distance, context);
+                ASSERT_EQ(actual.distance(), expected.distance());
+                ASSERT_EQ(actual.pathCount(), expected.pathCount());
+                std::vector<int> a, b;
+                while (expected.nextPath(a)) {
+                    ASSERT_TRUE(actual.nextPath(b));
+                    ASSERT_EQ(a, b);
+                }
+                EXPECT_FALSE(actual.nextPath(b));
+            }
+        }
+    }
+}
+
+// 测试用例37: 蒙特卡洛置信区间按 t 分布放宽，单批次时区间无界
+TEST(PageRankTest, MonteCarloIntervalUsesStudentT) {
+    std::vector<int> tokens;
+    for (int i = 0; i < 200; i++) {
+        tokens.push_back(i % 7);
+        tokens.push_back((i * 3) % 5);
+    }
+    Graph graph(7);
+    buildGraph(tokens, graph);
+
+    MonteCarloPageRank single = monteCarloPageRank(graph, 1, DAMPING_FACTOR, 3);
+    for (double width : single.half_width) {
+        EXPECT_TRUE(std::isinf(width));
+    }
+
+    // 两批次时第一批与单批次相同，由此还原第二批的估计并按自由度 1 的 t 分位数计算半宽
+    MonteCarloPageRank pair = monteCarloPageRank(graph, 2, DAMPING_FACTOR, 3);
+    double first_total = single.steps + 7.0;
+    double second_total = pair.steps + 14.0 - first_total;
+    for (int v = 0; v < 7; v++) {
+        double x1 = single.ranks[v];
+        double x2 = (pair.ranks[v] * (pair.steps + 14.0) - x1 * first_total) / second_total;
+        double variance = (x1 - pair.ranks[v]) * (x1 - pair.ranks[v]) + (x2 - pair.ranks[v]) * (x2 - pair.ranks[v]);
+        EXPECT_TRUE(std::isfinite(pair.half_width[v]));
+        EXPECT_NEAR(pair.half_width[v], 12.706 * std::sqrt(variance / 2), 1e-9);
+    }
+}
+
+// 测试用例38: PageRank 残差是浮点 L1 变化量，不会被截断为整数而提前收敛
+TEST(PageRankTest, ResidualIsFractionalL1Change) {
+    std::vector<int> tokens = {0, 1, 2, 0, 2, 3, 1, 0, 3, 2};
+    Graph graph(4);
+    buildGraph(tokens, graph);
+    PageRankEngine engine(graph);
+
+    std::vector<double> start(4, 0.25), next;
+    engine.step(start, next, DAMPING_FACTOR);
+    double expected = 0.0;
+    for (int v = 0; v < 4; v++) {
+        expected += std::fabs(next[v] - start[v]);
+    }
+    ASSERT_GT(expected, 0.0);
+    ASSERT_LT(expected, 1.0);
+
+    PageRankOptions options;
+    std::vector<double> rank = start;
+    PageRankStats stats = engine.solve(rank, options);
+    EXPECT_DOUBLE_EQ(stats.residuals[0], expected);
+    EXPECT_GT(stats.iterations, 1);
+    EXPECT_TRUE(stats.converged);
+}
+
+// 测试用例39: 增量 PageRank 前置条件不满足时回退到完整迭代
+TEST(PageRankTest, IncrementalUpdateFallsBackOnBadInput) {
+    std::vector<int> tokens = {0, 1, 2, 0, 2, 3, 1, 0, 3, 2, 4, 0};
+    Graph after(5);
+    buildGraph(tokens, after);
+    PageRankEngine engine(after);
+    std::vector<double> expected(5, 0.2);
+    engine.run(expected, DAMPING_FACTOR, MAX_ITERATIONS, 1e-12);
+
+    Graph empty(0);
+    empty.finalize();
+    std::vector<double> rank;
+    EXPECT_EQ(updatePageRank(empty, after, rank, DAMPING_FACTOR, 1e-12), 0);
+    ASSERT_EQ(rank.size(), 5u);
+    for (int v = 0; v < 5; v++) {
+        EXPECT_NEAR(rank[v], expected[v], 1e-9);
+    }
+
+    // 秩向量长度与旧图不符
+    Graph before(4);
+    buildGraph(std::vector<int>(tokens.begin(), tokens.begin() + 10), before);
+    rank.assign(3, 1.0 / 3);
+    EXPECT_EQ(updatePageRank(before, after, rank, DAMPING_FACTOR, 1e-12), 0);
+    ASSERT_EQ(rank.size(), 5u);
+    for (int v = 0; v < 5; v++) {
+        EXPECT_NEAR(rank[v], expected[v], 1e-9);
+    }
+
+    // 新图词数少于旧图
+    rank = expected;
+    Graph smaller(4);
+    buildGraph(std::vector<int>(tokens.begin(), tokens.begin() + 10), smaller);
+    EXPECT_EQ(updatePageRank(after, smaller, rank, DAMPING_FACTOR, 1e-12), 0);
+    EXPECT_EQ(rank.size(), 4u);
+}
+
+// 测试用例40: 地标查询直接在工作区上构建最短路径 DAG，与稠密距离数组结果一致
+TEST(ShortestPathTest, LandmarkDagReadsWorkspace) {
+    std::mt19937 gen(41);
+    int n = 40;
+    Graph graph(n);
+    for (int k = 0; k < 120; k++) {
+        graph.addEdge(gen() % n, gen() % n, 1 + gen() % 3);
+    }
+    graph.finalize();
+    LandmarkIndex index(graph, 4);
+    QueryContext context;
+
+    for (int s = 0; s < n; s++) {
+        for (int t = 0; t < n; t++) {
+            std::vector<int> labels;
+            int expected_distance = index.query(s, t, labels);
+            int distance = index.query(s, t, context.forward);
+            ASSERT_EQ(distance, expected_distance);
+            ShortestPathDag expected(graph, s, t, labels);
+            ShortestPathDag actual(graph, s, t, distance, context.forward, context.paths);
+            ASSERT_EQ(actual.pathCount(), expected.pathCount());
+            std::vector<int> a, b;
+            while (expected.nextPath(a)) {
+                ASSERT_TRUE(actual.nextPath(b));
+                ASSERT_EQ(a, b);
+            }
+            EXPECT_FALSE(actual.nextPath(b));
+        }
+    }
+}
+
+// 测试用例41: 多线程同时随机选取桥接词，结果都属于桥接词集合
+TEST(BridgeWordIndexTest, ConcurrentRandomPicks) {
+    WordTable table;
+    std::vector<int> tokens;
+    for (int i = 0; i < 50; i++) {
+        table.addWord("w" + std::to_string(i));
+    }
+    for (int b = 2; b < 50; b++) {
+        tokens.insert(tokens.end(), {0, b, 1});
+    }
+    Graph graph(50);
+    buildGraph(tokens, graph);
+    BridgeWordIndex index(graph);
+
+    std::atomic<int> bad(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 2000; i++) {
+                std::string word = (i + t) % 2 ? selectRandomBridgeWord(index, table, 0, 1)
+                                               : selectRandomBridgeWord(graph, table, 0, 1);
+                int id = table.getIndex(word);
+                if (id < 2) bad++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(bad.load(), 0);
+}
+
 // int main(int argc, char **argv) {
 //     testing::InitGoogleTest(&argc, argv);
 //     return RUN_ALL_TESTS();